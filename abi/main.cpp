@@ -20,6 +20,11 @@ extern "C" bool is_error_set(void);
 extern "C" const char* get_last_error(void);
 
 
+// Write out the counters of a program built to collect a profile, also defined in
+// sorth-runtime.lib.
+extern "C" void write_profile_data(void);
+
+
 // This function is also defined in sorth-runtime.lib.
 namespace sorth::run_time::abi::words
 {
@@ -62,6 +67,9 @@ int main(int argc, char* argv[])
         result = EXIT_FAILURE;
     }
 
+    // If the program was built to collect a profile, save it now that the program is done.
+    write_profile_data();
+
     // Return the result of the script execution to the OS.
     return result;
 }
@@ -0,0 +1,8 @@
+
+[include] core-words.f
+
+
+[include] array.f
+
+
+[include] structure.f
@@ -1,16 +1,121 @@
-
 #include "sorth-runtime.h"
 
 
 
 using namespace sorth::run_time::data_structures;
+using namespace sorth::run_time::abi;
+
+
+extern "C"
+{
+
+
+    thread_local DataStack data_stack = { nullptr, nullptr, nullptr };
+
+
+}
 
 
 namespace
 {
 
 
-    thread_local std::vector<Value> data_stack;
+    const size_t minimum_stack_size = 1024;
+
+
+    // Make sure that the stack's memory is released when the owning thread exits.
+    struct DataStackOwner
+    {
+        ~DataStackOwner() noexcept
+        {
+            for (auto iter = data_stack.base; iter != data_stack.top; ++iter)
+            {
+                iter->~Value();
+            }
+
+            ::operator delete(data_stack.base, std::align_val_t(alignof(Value)));
+
+            data_stack = { nullptr, nullptr, nullptr };
+        }
+    };
+
+
+    thread_local DataStackOwner data_stack_owner;
+
+
+    size_t stack_depth() noexcept
+    {
+        return data_stack.top - data_stack.base;
+    }
+
+
+    // Grow the stack so that there's room for at least one more value.  The existing values are
+    // moved into the new buffer.
+    void grow_stack()
+    {
+        // Touch the owner so that it gets constructed, and thus destructed, with this thread.
+        (void)&data_stack_owner;
+
+        size_t depth = stack_depth();
+        size_t capacity = data_stack.limit - data_stack.base;
+        size_t new_capacity = std::max(minimum_stack_size, capacity * 2);
+
+        auto new_base = static_cast<Value*>(::operator new(new_capacity * sizeof(Value),
+                                                           std::align_val_t(alignof(Value))));
+
+        for (size_t i = 0; i < depth; ++i)
+        {
+            new (&new_base[i]) Value(std::move(data_stack.base[i]));
+            data_stack.base[i].~Value();
+        }
+
+        ::operator delete(data_stack.base, std::align_val_t(alignof(Value)));
+
+        data_stack.base = new_base;
+        data_stack.top = new_base + depth;
+        data_stack.limit = new_base + new_capacity;
+    }
+
+
+    template <typename ValueType>
+    void push(ValueType&& value)
+    {
+        if (data_stack.top == data_stack.limit)
+        {
+            // Take a copy first, the value could be living in the stack we're about to move.
+            Value new_value(std::forward<ValueType>(value));
+
+            grow_stack();
+            new (data_stack.top) Value(std::move(new_value));
+        }
+        else
+        {
+            new (data_stack.top) Value(std::forward<ValueType>(value));
+        }
+
+        ++data_stack.top;
+    }
+
+
+    // Remove the top value from the stack.  The caller must have checked that the stack isn't
+    // empty.
+    Value pop() noexcept
+    {
+        --data_stack.top;
+
+        Value value = std::move(*data_stack.top);
+        data_stack.top->~Value();
+
+        return value;
+    }
+
+
+    // Drop the top value from the stack.  The caller must have checked that the stack isn't empty.
+    void drop() noexcept
+    {
+        --data_stack.top;
+        data_stack.top->~Value();
+    }
 
 
 }
@@ -22,73 +127,116 @@ extern "C"
 
     void stack_initialize()
     {
-        data_stack.clear();
-        data_stack.reserve(1024);
+        while (data_stack.top != data_stack.base)
+        {
+            --data_stack.top;
+            data_stack.top->~Value();
+        }
+
+        if (static_cast<size_t>(data_stack.limit - data_stack.base) < minimum_stack_size)
+        {
+            grow_stack();
+        }
     }
 
 
     void stack_push(const Value* value)
     {
-        data_stack.push_back(*value);
+        push(*value);
+    }
+
+
+    void stack_push_move(Value* value)
+    {
+        push(std::move(*value));
     }
 
 
     void stack_push_int(int64_t value)
     {
-        data_stack.push_back(value);
+        push(value);
     }
 
 
     void stack_push_double(double value)
     {
-        data_stack.push_back(value);
+        push(value);
     }
 
 
     void stack_push_bool(bool value)
     {
-        data_stack.push_back(value);
+        push(value);
     }
 
 
     void stack_push_string(const char* value)
     {
-        data_stack.push_back(std::string(value));
+        push(std::string(value));
     }
 
 
     int8_t stack_pop(Value* value)
     {
-        if (data_stack.empty())
+        if (data_stack.top == data_stack.base)
+        {
+            return 1;
+        }
+
+        *value = pop();
+
+        return 0;
+    }
+
+
+    int8_t stack_pop_move(Value* value)
+    {
+        if (data_stack.top == data_stack.base)
         {
+            new (value) Value();
             return 1;
         }
 
-        *value = data_stack.back();
-        data_stack.pop_back();
+        --data_stack.top;
+
+        new (value) Value(std::move(*data_stack.top));
+        data_stack.top->~Value();
 
         return 0;
     }
 
 
+    Value* stack_top()
+    {
+        if (data_stack.top == data_stack.base)
+        {
+            return nullptr;
+        }
+
+        return data_stack.top - 1;
+    }
+
+
     int8_t stack_pop_int(int64_t* value)
     {
-        if (data_stack.empty())
+        if (data_stack.top == data_stack.base)
         {
             set_last_error("Stack underflow.");
             return 1;
         }
 
-        auto new_value = data_stack.back();
-        data_stack.pop_back();
+        // Scalars are read straight out of the stack instead of being moved out first.
+        const Value& top = data_stack.top[-1];
 
-        if (!new_value.is_numeric())
+        if (!top.is_numeric())
         {
+            drop();
             set_last_error("Value is not an integer.");
             return 1;
         }
 
-        *value = new_value.get_int();
+        *value = top.get_int();
+        drop();
 
         return 0;
     }
@@ -96,20 +244,21 @@ extern "C"
 
     int8_t stack_pop_bool(bool* value)
     {
-        if (data_stack.empty())
+        if (data_stack.top == data_stack.base)
         {
             return 1;
         }
 
-        auto new_value = data_stack.back();
-        data_stack.pop_back();
+        const Value& top = data_stack.top[-1];
 
-        if (!new_value.is_numeric())
+        if (!top.is_numeric())
         {
+            drop();
             return 1;
         }
 
-        *value = new_value.get_bool();
+        *value = top.get_bool();
+        drop();
 
         return 0;
     }
@@ -117,20 +266,21 @@ extern "C"
 
     int8_t stack_pop_double(double* value)
     {
-        if (data_stack.empty())
+        if (data_stack.top == data_stack.base)
         {
             return 1;
         }
 
-        auto new_value = data_stack.back();
-        data_stack.pop_back();
+        const Value& top = data_stack.top[-1];
 
-        if (!new_value.is_numeric())
+        if (!top.is_numeric())
         {
+            drop();
             return 1;
         }
 
-        *value = new_value.get_double();
+        *value = top.get_double();
+        drop();
 
         return 0;
     }
@@ -138,23 +288,26 @@ extern "C"
 
     int8_t stack_pop_string(char** value)
     {
-        if (data_stack.empty())
+        if (data_stack.top == data_stack.base)
         {
             return 1;
         }
 
-        auto new_value = data_stack.back();
-        data_stack.pop_back();
+        const Value& top = data_stack.top[-1];
 
-        if (!new_value.is_string())
+        if (!top.is_string())
         {
+            drop();
             return 1;
         }
 
-        const auto& string_value = new_value.get_string();
+        auto string_value = top.get_string();
 
         *value = new char[string_value.size() + 1];
-        std::strcpy(*value, string_value.c_str());
+        std::memcpy(*value, string_value.data(), string_value.size());
+        (*value)[string_value.size()] = 0;
+
+        drop();
 
         return 0;
     }
@@ -1,18 +1,46 @@
-
 #pragma once
 
 
 
+namespace sorth::run_time::abi
+{
+
+
+    // The raw layout of a thread's data stack.  The generated code accesses this structure directly
+    // so that pushing and popping scalar values doesn't require a call into the run-time.  The
+    // values between base and top are live, and top never passes limit.
+    struct DataStack
+    {
+        sorth::run_time::data_structures::Value* base;
+        sorth::run_time::data_structures::Value* top;
+        sorth::run_time::data_structures::Value* limit;
+    };
+
+
+}
+
+
 extern "C"
 {
 
 
+    // Each thread gets it's own data stack.  The generated code is free to read and write this
+    // directly, falling back to the functions below when the stack needs to grow or the value
+    // being accessed isn't a simple scalar.
+    extern thread_local sorth::run_time::abi::DataStack data_stack;
+
+
     void stack_initialize();
 
 
     void stack_push(const sorth::run_time::data_structures::Value* value);
 
 
+    // Push a value that the caller is done with by moving it onto the stack.  The value is left
+    // empty so that freeing it afterwards is optional.
+    void stack_push_move(sorth::run_time::data_structures::Value* value);
+
+
     void stack_push_int(int64_t value);
 
 
@@ -28,6 +56,16 @@ extern "C"
     int8_t stack_pop(sorth::run_time::data_structures::Value* value);
 
 
+    // Pop the top value into uninitialized storage by moving it there.  The storage always holds a
+    // valid value afterwards, even on stack underflow, so it doesn't need to be initialized first.
+    int8_t stack_pop_move(sorth::run_time::data_structures::Value* value);
+
+
+    // Get the value on top of the stack so that it can be read or modified in place.  Returns
+    // nullptr if the stack is empty.
+    sorth::run_time::data_structures::Value* stack_top();
+
+
     int8_t stack_pop_int(int64_t* value);
 
 
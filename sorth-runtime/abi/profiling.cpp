@@ -0,0 +1,69 @@
+#include "sorth-runtime.h"
+
+
+
+namespace
+{
+
+
+    // The profile data registered by the generated code, if any.
+    const ProfileFunctionData* profile_functions = nullptr;
+    uint64_t profile_function_count = 0;
+    const char* profile_path = nullptr;
+
+
+}
+
+
+
+extern "C"
+{
+
+
+    void register_profile_data(const ProfileFunctionData* functions,
+                               uint64_t function_count,
+                               const char* path) noexcept
+    {
+        profile_functions = functions;
+        profile_function_count = function_count;
+        profile_path = path;
+    }
+
+
+    // The profile is a text file, a header line followed by a line for each function.  Each of
+    // those lines has the function's name, the number of counters, and then the counters
+    // themselves.
+    void write_profile_data() noexcept
+    {
+        if (profile_functions == nullptr)
+        {
+            return;
+        }
+
+        std::ofstream stream(profile_path);
+
+        if (!stream)
+        {
+            std::cerr << "Could not write the profile file " << profile_path << "." << std::endl;
+            return;
+        }
+
+        stream << "sorth-profile 1\n";
+
+        for (uint64_t i = 0; i < profile_function_count; ++i)
+        {
+            const auto& function = profile_functions[i];
+
+            stream << function.name << " " << function.counter_count;
+
+            for (uint64_t j = 0; j < function.counter_count; ++j)
+            {
+                stream << " " << function.counters[j];
+            }
+
+            stream << "\n";
+        }
+    }
+
+
+}
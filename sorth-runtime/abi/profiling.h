@@ -0,0 +1,38 @@
+#pragma once
+
+
+
+extern "C"
+{
+
+
+    // Programs built with sorthc's --profile-generate option count how often each of their
+    // functions is called and which way each of their branches go.  The generated code describes
+    // each instrumented function with one of these.
+    struct ProfileFunctionData
+    {
+        // The name of the function in the generated code.
+        const char* name;
+
+        // The function's counters.  The first counts the calls to the function, followed by a
+        // taken and not taken count for each of the function's conditional branches.
+        uint64_t* counters;
+
+        // How many counters the function has.
+        uint64_t counter_count;
+    };
+
+
+    // Called by the generated code as the program starts to let us know where it's counters are
+    // and which file they should be written to.
+    void register_profile_data(const ProfileFunctionData* functions,
+                               uint64_t function_count,
+                               const char* path) noexcept;
+
+
+    // Called as the program exits to write the counters out to the profile file.  Does nothing if
+    // the program wasn't built to collect a profile.
+    void write_profile_data() noexcept;
+
+
+}
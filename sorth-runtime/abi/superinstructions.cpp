@@ -0,0 +1,134 @@
+
+#include "sorth-runtime.h"
+
+
+
+using namespace sorth::run_time::data_structures;
+
+
+
+namespace
+{
+
+
+    // Get the array from a variable, and make sure that the index is within it's bounds.  The
+    // errors match the ones raised by the array words.
+    ArrayPtr checked_array(const Value* variable, int64_t index) noexcept
+    {
+        if (!variable->is_array())
+        {
+            set_last_error("Expected an array value.");
+            return nullptr;
+        }
+
+        auto array = variable->get_array();
+
+        if (static_cast<size_t>(index) >= array->size())
+        {
+            set_last_error("Index out of bounds for array value.");
+            return nullptr;
+        }
+
+        return array;
+    }
+
+
+    HashTablePtr checked_hash_table(const Value* variable) noexcept
+    {
+        if (!variable->is_hash_table())
+        {
+            set_last_error("Expected a hash table value.");
+            return nullptr;
+        }
+
+        return variable->get_hash_table();
+    }
+
+
+}
+
+
+
+extern "C"
+{
+
+
+    // Read an item from the array held in the variable, as: index variable @ []@
+    bool variable_array_read(const Value* variable, int64_t index, Value* output) noexcept
+    {
+        auto array = checked_array(variable, index);
+
+        if (!array)
+        {
+            return true;
+        }
+
+        (*output) = (*array)[index];
+
+        return false;
+    }
+
+
+    // Write an item to the array held in the variable, as: value index variable @ []!
+    bool variable_array_write(const Value* variable, int64_t index, const Value* value) noexcept
+    {
+        auto array = checked_array(variable, index);
+
+        if (!array)
+        {
+            return true;
+        }
+
+        (*array)[index] = (*value);
+
+        return false;
+    }
+
+
+    // Find a value in the hash table held in the variable, as: key variable @ {}@
+    bool variable_hash_table_read(const Value* variable, const Value* key, Value* output) noexcept
+    {
+        auto table = checked_hash_table(variable);
+
+        if (!table)
+        {
+            return true;
+        }
+
+        auto [ found, value ] = table->get(*key);
+
+        if (!found)
+        {
+            std::stringstream stream;
+
+            stream << "Value, " << (*key) << ", does not exist in the table.";
+            set_last_error(stream.str().c_str());
+
+            return true;
+        }
+
+        (*output) = value;
+
+        return false;
+    }
+
+
+    // Insert a value into the hash table held in the variable, as: value key variable @ {}!
+    bool variable_hash_table_write(const Value* variable,
+                                   const Value* key,
+                                   const Value* value) noexcept
+    {
+        auto table = checked_hash_table(variable);
+
+        if (!table)
+        {
+            return true;
+        }
+
+        table->insert(*key, *value);
+
+        return false;
+    }
+
+
+}
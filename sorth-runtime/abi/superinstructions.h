@@ -0,0 +1,38 @@
+#pragma once
+
+
+
+extern "C"
+{
+
+
+    // Fused versions of common word sequences.  The generated code calls these when it sees a
+    // container held in one of its own variables being accessed, so that the container doesn't
+    // have to be copied onto the stack and popped back off again by the word.
+
+
+    // Read an item from the array held in the variable, as: index variable @ []@
+    bool variable_array_read(const sorth::run_time::data_structures::Value* variable,
+                             int64_t index,
+                             sorth::run_time::data_structures::Value* output) noexcept;
+
+
+    // Write an item to the array held in the variable, as: value index variable @ []!
+    bool variable_array_write(const sorth::run_time::data_structures::Value* variable,
+                              int64_t index,
+                              const sorth::run_time::data_structures::Value* value) noexcept;
+
+
+    // Find a value in the hash table held in the variable, as: key variable @ {}@
+    bool variable_hash_table_read(const sorth::run_time::data_structures::Value* variable,
+                                  const sorth::run_time::data_structures::Value* key,
+                                  sorth::run_time::data_structures::Value* output) noexcept;
+
+
+    // Insert a value into the hash table held in the variable, as: value key variable @ {}!
+    bool variable_hash_table_write(const sorth::run_time::data_structures::Value* variable,
+                                   const sorth::run_time::data_structures::Value* key,
+                                   const sorth::run_time::data_structures::Value* value) noexcept;
+
+
+}
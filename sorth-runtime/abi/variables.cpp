@@ -18,34 +18,28 @@ namespace sorth::run_time::abi
         //
         // The user code will allocate a block of variables, and if it needs to access the variable
         // list by index, it will use these slabs to access the variables.
+        //
+        // The slabs are kept as one flat array of variable pointers, indexed directly by the
+        // variable's index, along with a stack of where each slab starts.  Both arrays keep their
+        // capacity as slabs are released, so once a thread has reached its deepest call depth
+        // allocating and releasing slabs doesn't touch the heap.
         class VariableBlock
         {
             private:
-                // A block of variables that have been allocated on the stack.
-                struct Block
-                {
-                    size_t start;    // The index of the first variable in the block.
-                    size_t size;     // The number of variables in the block.
+                // Pointers to all of the variables in all of the active slabs.
+                std::vector<Value*> slots;
 
-                    Value** values;  // Pointers to the variables in the block.
-                };
-
-            private:
-                // The stack of slabs that have been allocated.
-                std::list<Block> slabs;
+                // The starting index of each of the active slabs.
+                std::vector<size_t> slab_starts;
 
             public:
                 // Allocate a new block of variables on the stack.
                 int64_t allocate(Value* block[], size_t size) noexcept
                 {
-                    size_t start = 0;
-
-                    if (!slabs.empty())
-                    {
-                        start = slabs.front().start + slabs.front().size;
-                    }
+                    size_t start = slots.size();
 
-                    slabs.push_front({.start = start, .size = size, .values = block});
+                    slab_starts.push_back(start);
+                    slots.insert(slots.end(), block, block + size);
 
                     return start;
                 }
@@ -53,25 +47,22 @@ namespace sorth::run_time::abi
                 // Release the most recently allocated block of variables.
                 void release() noexcept
                 {
-                    if (!slabs.empty())
+                    if (!slab_starts.empty())
                     {
-                        slabs.pop_front();
+                        slots.resize(slab_starts.back());
+                        slab_starts.pop_back();
                     }
                 }
 
                 // Get a variable from one of the blocks by index.
                 Value* get(size_t index) noexcept
                 {
-                    for (const auto& block : slabs)
+                    if (index >= slots.size())
                     {
-                        if (   (index >= block.start)
-                            && (index < (block.start + block.size)))
-                        {
-                            return block.values[index - block.start];
-                        }
+                        return nullptr;
                     }
 
-                    return nullptr;
+                    return slots[index];
                 }
         };
 
@@ -141,13 +132,14 @@ extern "C"
     }
 
 
-    // Search the list of slabs for the variable by index and return the value.
+    // Look up the variable by index and return the value.
     bool read_variable(size_t index, Value* output) noexcept
     {
         auto variable = variables.get(index);
 
         if (variable == nullptr)
         {
+            set_last_error("Variable index " + std::to_string(index) + " is out of range.");
             return true;
         }
 
@@ -157,13 +149,14 @@ extern "C"
     }
 
 
-    // Search the list of slabs for the variable by index and write the value.
+    // Look up the variable by index and write the value.
     bool write_variable(size_t index, Value* value) noexcept
     {
         auto variable = variables.get(index);
 
         if (variable == nullptr)
         {
+            set_last_error("Variable index " + std::to_string(index) + " is out of range.");
             return true;
         }
 
@@ -173,6 +166,37 @@ extern "C"
     }
 
 
+    // Look up the variable by index and move the value into it.
+    bool replace_variable(size_t index, Value* value) noexcept
+    {
+        auto variable = variables.get(index);
+
+        if (variable == nullptr)
+        {
+            set_last_error("Variable index " + std::to_string(index) + " is out of range.");
+            return true;
+        }
+
+        (*variable) = std::move(*value);
+
+        return false;
+    }
+
+
+    // Called by generated code to copy the value of one local variable to another.
+    void copy_variable(const Value* input, Value* output) noexcept
+    {
+        (*output) = (*input);
+    }
+
+
+    // Called by generated code to move the value of one local variable to another.
+    void take_variable(Value* input, Value* output) noexcept
+    {
+        (*output) = std::move(*input);
+    }
+
+
     // Called by generated code to copy the value of one variable to another.
     void deep_copy_variable(Value* input, Value* output) noexcept
     {
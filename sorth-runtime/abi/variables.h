@@ -34,14 +34,30 @@ extern "C"
                                 uint8_t** output) noexcept;
 
 
-    // Search the list of slabs for the variable by index and return the value.
+    // Look up the variable by index and return the value.
     bool read_variable(size_t index, sorth::run_time::data_structures::Value* output) noexcept;
 
 
-    // Search the list of slabs for the variable by index and write the value.
+    // Look up the variable by index and write the value.
     bool write_variable(size_t index, sorth::run_time::data_structures::Value* value) noexcept;
 
 
+    // Look up the variable by index and move the value into it, leaving the value empty.  Used
+    // when the value being written isn't needed afterwards.
+    bool replace_variable(size_t index, sorth::run_time::data_structures::Value* value) noexcept;
+
+
+    // Called by generated code to copy the value of one local variable to another.
+    void copy_variable(const sorth::run_time::data_structures::Value* input,
+                       sorth::run_time::data_structures::Value* output) noexcept;
+
+
+    // Called by generated code to move the value of one local variable to another when the input
+    // isn't needed afterwards.  The input is left empty.
+    void take_variable(sorth::run_time::data_structures::Value* input,
+                       sorth::run_time::data_structures::Value* output) noexcept;
+
+
     // Called by generated code to copy the value of one variable to another.
     void deep_copy_variable(sorth::run_time::data_structures::Value* input,
                             sorth::run_time::data_structures::Value* output) noexcept;
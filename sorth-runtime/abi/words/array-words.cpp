@@ -84,9 +84,9 @@ extern "C"
                 return 1;
             }
 
-            Value array_ptr = std::make_shared<Array>(count);
+            Value array_ptr = make_ref<Array>(count);
 
-            stack_push(&array_ptr);
+            stack_push_move(&array_ptr);
 
             return 0;
         }
@@ -222,7 +222,7 @@ extern "C"
 
             Value value = array_dest;
 
-            stack_push(&value);
+            stack_push_move(&value);
 
             return 0;
         }
@@ -297,7 +297,7 @@ extern "C"
 
             Value value = array->pop_front();
 
-            stack_push(&value);
+            stack_push_move(&value);
 
             return 0;
         }
@@ -320,7 +320,7 @@ extern "C"
 
             Value value = array->pop_back();
 
-            stack_push(&value);
+            stack_push_move(&value);
 
             return 0;
         }
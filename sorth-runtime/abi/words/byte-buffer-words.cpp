@@ -70,9 +70,9 @@ extern "C"
             return 1;
         }
 
-        Value buffer = std::make_shared<ByteBuffer>(static_cast<size_t>(size));
+        Value buffer = make_ref<ByteBuffer>(static_cast<size_t>(size));
 
-        stack_push(&buffer);
+        stack_push_move(&buffer);
 
         return 0;
     }
@@ -200,7 +200,7 @@ extern "C"
             return 1;
         }
 
-        buffer->write_string(value.get_string(), max_size);
+        buffer->write_string(std::string(value.get_string()), max_size);
 
         return 0;
     }
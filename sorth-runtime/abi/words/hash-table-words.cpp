@@ -46,10 +46,10 @@ extern "C"
 
         uint8_t word_hash_table_new()
         {
-            auto table = std::make_shared<HashTable>();
+            auto table = make_ref<HashTable>();
             auto value = Value(table);
 
-            stack_push(&value);
+            stack_push_move(&value);
 
             return 0;
         }
@@ -99,7 +99,7 @@ extern "C"
                 return 1;
             }
 
-            stack_push(&value);
+            stack_push_move(&value);
 
             return 0;
         }
@@ -145,7 +145,7 @@ extern "C"
 
             Value value = hash_dest;
 
-            stack_push(&value);
+            stack_push_move(&value);
 
             return 0;
         }
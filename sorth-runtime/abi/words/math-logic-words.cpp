@@ -54,33 +54,34 @@ extern "C"
                             std::function<int64_t(int64_t, int64_t)> iop)
             {
                 Value b;
-                Value a;
 
-                auto pop_result_1 = stack_pop(&b);
-                auto pop_result_2 = stack_pop(&a);
+                auto pop_result = stack_pop(&b);
 
-                if (pop_result_1 || pop_result_2)
+                // The result replaces the first operand in place on the top of the stack.
+                auto a = stack_top();
+
+                if (pop_result || !a)
                 {
                     return 1;
                 }
 
-                Value result;
-
-                if (Value::either_is_float(a, b))
+                if (Value::either_is_float(*a, b))
                 {
-                    result = dop(a.get_double(), b.get_double());
+                    *a = dop(a->get_double(), b.get_double());
                 }
-                else if (Value::either_is_integer(a, b))
+                else if (Value::either_is_integer(*a, b))
                 {
-                    result = iop(a.get_int(), b.get_int());
+                    *a = iop(a->get_int(), b.get_int());
                 }
                 else
                 {
+                    Value discard;
+
+                    stack_pop(&discard);
                     set_last_error("Expected numeric values.");
                     return 1;
                 }
 
-                stack_push(&result);
                 return 0;
             }
 
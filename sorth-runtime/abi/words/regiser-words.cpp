@@ -64,7 +64,7 @@ namespace sorth::run_time::abi::words
     // Called at run-time startup to make the command line arguments available to the Forth program.
     void register_command_line_arguments(int argc, char* argv[])
     {
-        auto new_array = std::make_shared<data_structures::Array>(argc);
+        auto new_array = data_structures::make_ref<data_structures::Array>(argc);
 
         for (int i = 0; i < argc; ++i)
         {
@@ -71,7 +71,7 @@ extern "C"
             return 1;
         }
 
-        auto key = key_value.get_string();
+        std::string key(key_value.get_string());
         const char* value = std::getenv(key.c_str());
 
         if (value)
@@ -140,7 +140,7 @@ extern "C"
             return 1;
         }
 
-        set_last_error(message_value.get_string().c_str());
+        set_last_error(std::string(message_value.get_string()).c_str());
 
         return 1;
     }
@@ -192,6 +192,53 @@ extern "C"
     }
 
 
+    // Push an array with the occupancy of each of this thread's allocation pools.  Each entry is
+    // an array of the pool's block size, blocks in use, free blocks, and chunk count.
+    int8_t word_pool_statistics()
+    {
+        auto statistics = pool_statistics();
+        auto pools = make_ref<Array>(statistics.size());
+
+        for (size_t i = 0; i < statistics.size(); ++i)
+        {
+            auto entry = make_ref<Array>(4);
+
+            (*entry)[0] = static_cast<int64_t>(statistics[i].block_size);
+            (*entry)[1] = statistics[i].blocks_in_use;
+            (*entry)[2] = static_cast<int64_t>(statistics[i].blocks_free);
+            (*entry)[3] = static_cast<int64_t>(statistics[i].chunk_count);
+
+            (*pools)[i] = entry;
+        }
+
+        Value value = pools;
+
+        stack_push_move(&value);
+
+        return 0;
+    }
+
+
+    // Print a table of the occupancy of this thread's allocation pools.
+    int8_t word_pool_statistics_print()
+    {
+        std::cout << std::setw(12) << "block size"
+                  << std::setw(12) << "in use"
+                  << std::setw(12) << "free"
+                  << std::setw(12) << "chunks" << std::endl;
+
+        for (const auto& pool : pool_statistics())
+        {
+            std::cout << std::setw(12) << pool.block_size
+                      << std::setw(12) << pool.blocks_in_use
+                      << std::setw(12) << pool.blocks_free
+                      << std::setw(12) << pool.chunk_count << std::endl;
+        }
+
+        return 0;
+    }
+
+
     int8_t execute()
     {
         int64_t index;
@@ -243,6 +290,9 @@ namespace sorth::run_time::abi::words
         registrar("true", "word_true");
         registrar("false", "word_false");
         registrar("execute", "execute");
+
+        registrar("sorth.pool-stats", "word_pool_statistics");
+        registrar("sorth.pool-stats.print", "word_pool_statistics_print");
     }
 
 
@@ -4,8 +4,135 @@
 
 
 
+using namespace sorth::run_time::data_structures;
+
+
+
+namespace
+{
+
+
+    // Make sure that there are at least the given number of values on the stack.
+    bool check_depth(size_t count)
+    {
+        if (static_cast<size_t>(data_stack.top - data_stack.base) < count)
+        {
+            set_last_error("Stack underflow.");
+            return false;
+        }
+
+        return true;
+    }
+
+
+    // Remove the top value from the stack, throwing it away.
+    void discard_top()
+    {
+        --data_stack.top;
+        data_stack.top->~Value();
+    }
+
+
+}
+
+
+
 extern "C"
 {
+
+
+        // Duplicate the top item on the stack.
+        // Signature: a -- a a
+        uint8_t word_dup()
+        {
+            if (!check_depth(1))
+            {
+                return 1;
+            }
+
+            stack_push(data_stack.top - 1);
+
+            return 0;
+        }
+
+
+        // Drop the top item from the stack.
+        // Signature: a --
+        uint8_t word_drop()
+        {
+            if (!check_depth(1))
+            {
+                return 1;
+            }
+
+            discard_top();
+
+            return 0;
+        }
+
+
+        // Swap the top two items on the stack.
+        // Signature: a b -- b a
+        uint8_t word_swap()
+        {
+            if (!check_depth(2))
+            {
+                return 1;
+            }
+
+            std::swap(data_stack.top[-1], data_stack.top[-2]);
+
+            return 0;
+        }
+
+
+        // Duplicate the second item on the stack.
+        // Signature: a b -- b a b
+        uint8_t word_over()
+        {
+            if (!check_depth(2))
+            {
+                return 1;
+            }
+
+            std::swap(data_stack.top[-1], data_stack.top[-2]);
+            stack_push(data_stack.top - 2);
+
+            return 0;
+        }
+
+
+        // Rotate the top three items on the stack.
+        // Signature: a b c -- c a b
+        uint8_t word_rot()
+        {
+            if (!check_depth(3))
+            {
+                return 1;
+            }
+
+            std::rotate(data_stack.top - 3, data_stack.top - 1, data_stack.top);
+
+            return 0;
+        }
+
+
+        // Nip the second from the top item from the stack.
+        // Signature: a b -- b
+        uint8_t word_nip()
+        {
+            if (!check_depth(2))
+            {
+                return 1;
+            }
+
+            data_stack.top[-2] = std::move(data_stack.top[-1]);
+            discard_top();
+
+            return 0;
+        }
+
+
 }
 
 
@@ -15,6 +142,12 @@ namespace sorth::run_time::abi::words
 
     void register_stack_words(const RuntimeWordRegistrar& registrar)
     {
+        registrar("dup", "word_dup");
+        registrar("drop", "word_drop");
+        registrar("swap", "word_swap");
+        registrar("over", "word_over");
+        registrar("rot", "word_rot");
+        registrar("nip", "word_nip");
     }
 
 
@@ -62,7 +62,7 @@ extern "C"
                 return 1;
             }
 
-            auto name = name_value.get_string();
+            std::string name(name_value.get_string());
             Value new_structure;
 
             auto create_result = create_structure(name, &new_structure);
@@ -72,7 +72,7 @@ extern "C"
                 return 1;
             }
 
-            stack_push(&new_structure);
+            stack_push_move(&new_structure);
 
             return 0;
         }
@@ -97,7 +97,7 @@ extern "C"
                 return 1;
             }
 
-            std::string type_name = type_value.get_string();
+            auto type_name = type_value.get_string();
 
             stack_push_bool(object->definition->name == type_name);
 
@@ -160,7 +160,7 @@ extern "C"
 
             Value copy = original.deep_copy();
 
-            stack_push(&copy);
+            stack_push_move(&copy);
 
             return 0;
         }
@@ -111,7 +111,7 @@ namespace sorth::run_time::data_structures
 
     Value Array::deep_copy() const noexcept
     {
-        ArrayPtr result = std::make_shared<Array>(items.size());
+        ArrayPtr result = make_ref<Array>(items.size());
 
         for (size_t i = 0; i < items.size(); ++i)
         {
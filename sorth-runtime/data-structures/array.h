@@ -7,7 +7,7 @@ namespace sorth::run_time::data_structures
 {
 
 
-    class Array
+    class Array : public HeapObject
     {
         private:
             std::vector<Value> items;
@@ -100,7 +100,7 @@ namespace sorth::run_time::data_structures
 
     ByteBuffer::ByteBuffer(size_t new_size)
     : owned(true),
-      bytes(new unsigned char[new_size]),
+      bytes(static_cast<unsigned char*>(pool_allocate(new_size))),
       byte_size(new_size),
       current_position(0)
     {
@@ -118,8 +118,10 @@ namespace sorth::run_time::data_structures
 
 
     ByteBuffer::ByteBuffer(const ByteBuffer& buffer)
-    : owned(true),
-      bytes(new unsigned char[buffer.byte_size]),
+    : Buffer(),
+      HeapObject(),
+      owned(true),
+      bytes(static_cast<unsigned char*>(pool_allocate(buffer.byte_size))),
       byte_size(buffer.byte_size),
       current_position(buffer.current_position)
     {
@@ -153,7 +155,7 @@ namespace sorth::run_time::data_structures
             reset();
 
             owned = true;
-            bytes = new unsigned char[buffer.byte_size];
+            bytes = static_cast<unsigned char*>(pool_allocate(buffer.byte_size));
             byte_size = buffer.byte_size;
             current_position = buffer.current_position;
         }
@@ -188,10 +190,10 @@ namespace sorth::run_time::data_structures
             throw std::runtime_error("Resizing a byte buffer that isn't owned.");
         }
 
-        auto new_buffer = new unsigned char[new_size];
+        auto new_buffer = static_cast<unsigned char*>(pool_allocate(new_size));
 
         memcpy(new_buffer, bytes, std::min(new_size, byte_size));
-        delete [] bytes;
+        pool_free(bytes, byte_size);
 
         byte_size = new_size;
         bytes = new_buffer;
@@ -379,10 +381,10 @@ namespace sorth::run_time::data_structures
 
     Value ByteBuffer::deep_copy() const noexcept
     {
-        auto new_buffer = new unsigned char[byte_size];
+        auto new_buffer = pool_allocate(byte_size);
         memcpy(new_buffer, bytes, byte_size);
 
-        return std::make_shared<ByteBuffer>(new_buffer, byte_size, true);
+        return make_ref<ByteBuffer>(new_buffer, byte_size, true);
     }
 
 
@@ -391,7 +393,7 @@ namespace sorth::run_time::data_structures
         if (   (owned)
             && (bytes != nullptr))
         {
-            delete []bytes;
+            pool_free(bytes, byte_size);
         }
 
         bytes = nullptr;
@@ -60,7 +60,7 @@ namespace sorth::run_time::data_structures
 
 
 
-    class ByteBuffer : public Buffer
+    class ByteBuffer : public Buffer, public HeapObject
     {
         private:
             bool owned;
@@ -71,6 +71,9 @@ namespace sorth::run_time::data_structures
 
         public:
             ByteBuffer(size_t size);
+
+            // Wrap an existing block of memory.  If the buffer is to own the memory it must have
+            // been allocated with pool_allocate.
             ByteBuffer(void* raw_ptr, size_t size, bool owned = false);
             ByteBuffer(const ByteBuffer& buffer);
             ByteBuffer(ByteBuffer&& buffer);
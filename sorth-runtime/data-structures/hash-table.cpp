@@ -131,7 +131,7 @@ namespace sorth::run_time::data_structures
 
     Value HashTable::deep_copy() const noexcept
     {
-        HashTablePtr result = std::make_shared<HashTable>();
+        HashTablePtr result = make_ref<HashTable>();
 
         for (const auto& [ key, value ] : items)
         {
@@ -7,7 +7,7 @@ namespace sorth::run_time::data_structures
 {
 
 
-    class HashTable
+    class HashTable : public HeapObject
     {
         private:
             std::unordered_map<Value, Value> items;
@@ -0,0 +1,13 @@
+#include "sorth-runtime.h"
+
+
+
+extern "C"
+{
+
+
+    // Default to the safe choice, the compiler turns this off for programs that don't need it.
+    bool atomic_reference_counts = true;
+
+
+}
@@ -0,0 +1,202 @@
+
+#pragma once
+
+
+
+extern "C"
+{
+
+
+    // Reference counts are only updated with atomic instructions when this is set.  The compiler
+    // clears it as the program starts if the program doesn't use any of the thread words.
+    extern bool atomic_reference_counts;
+
+
+}
+
+
+namespace sorth::run_time::data_structures
+{
+
+
+    // The base of all of the objects that a Value can refer to on the heap, strings and the
+    // containers.  The objects keep their own reference count so that a Value only needs a single
+    // pointer to share them, instead of the pointer and control block pair of a std::shared_ptr.
+    class HeapObject
+    {
+        private:
+            mutable std::atomic<uint32_t> reference_count;
+
+        public:
+            HeapObject() noexcept
+            : reference_count(0)
+            {
+            }
+
+            // Copies of an object start out with no references of their own.
+            HeapObject(const HeapObject&) noexcept
+            : reference_count(0)
+            {
+            }
+
+            HeapObject& operator =(const HeapObject&) noexcept
+            {
+                return *this;
+            }
+
+        public:
+            // Heap objects are allocated from the calling thread's pools.
+            static void* operator new(size_t size)
+            {
+                return pool_allocate(size);
+            }
+
+            static void* operator new(size_t, void* block) noexcept
+            {
+                return block;
+            }
+
+            static void operator delete(void* block, size_t size) noexcept
+            {
+                pool_free(block, size);
+            }
+
+        public:
+            void add_reference() const noexcept
+            {
+                if (atomic_reference_counts)
+                {
+                    reference_count.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                {
+                    reference_count.store(reference_count.load(std::memory_order_relaxed) + 1,
+                                          std::memory_order_relaxed);
+                }
+            }
+
+            // Returns true if this was the last reference and the object needs to be freed.
+            bool release_reference() const noexcept
+            {
+                if (atomic_reference_counts)
+                {
+                    return reference_count.fetch_sub(1, std::memory_order_acq_rel) == 1;
+                }
+
+                auto new_count = reference_count.load(std::memory_order_relaxed) - 1;
+                reference_count.store(new_count, std::memory_order_relaxed);
+
+                return new_count == 0;
+            }
+    };
+
+
+    // A reference counted pointer to one of the heap objects.  This keeps the same interface as
+    // the std::shared_ptr it replaced, for the parts of it that the run-time uses.
+    template <typename ObjectType>
+    class Ref
+    {
+        private:
+            ObjectType* object;
+
+        public:
+            Ref() noexcept
+            : object(nullptr)
+            {
+            }
+
+            Ref(std::nullptr_t) noexcept
+            : object(nullptr)
+            {
+            }
+
+            explicit Ref(ObjectType* new_object) noexcept
+            : object(new_object)
+            {
+                if (object)
+                {
+                    object->add_reference();
+                }
+            }
+
+            Ref(const Ref& other) noexcept
+            : Ref(other.object)
+            {
+            }
+
+            Ref(Ref&& other) noexcept
+            : object(std::exchange(other.object, nullptr))
+            {
+            }
+
+            ~Ref() noexcept
+            {
+                reset();
+            }
+
+        public:
+            Ref& operator =(const Ref& other) noexcept
+            {
+                Ref(other).swap(*this);
+                return *this;
+            }
+
+            Ref& operator =(Ref&& other) noexcept
+            {
+                Ref(std::move(other)).swap(*this);
+                return *this;
+            }
+
+        public:
+            void reset() noexcept
+            {
+                if (object && object->release_reference())
+                {
+                    delete object;
+                }
+
+                object = nullptr;
+            }
+
+            void swap(Ref& other) noexcept
+            {
+                std::swap(object, other.object);
+            }
+
+        public:
+            ObjectType* get() const noexcept
+            {
+                return object;
+            }
+
+            ObjectType& operator *() const noexcept
+            {
+                return *object;
+            }
+
+            ObjectType* operator ->() const noexcept
+            {
+                return object;
+            }
+
+            explicit operator bool() const noexcept
+            {
+                return object != nullptr;
+            }
+
+            friend bool operator ==(const Ref& lhs, std::nullptr_t) noexcept
+            {
+                return lhs.object == nullptr;
+            }
+    };
+
+
+    // Allocate a new heap object and return the first reference to it.
+    template <typename ObjectType, typename... Arguments>
+    Ref<ObjectType> make_ref(Arguments&&... arguments)
+    {
+        return Ref<ObjectType>(new ObjectType(std::forward<Arguments>(arguments)...));
+    }
+
+
+}
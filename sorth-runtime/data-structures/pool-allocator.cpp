@@ -0,0 +1,249 @@
+#include "sorth-runtime.h"
+
+
+
+namespace sorth::run_time::data_structures
+{
+
+
+    namespace
+    {
+
+
+        // The block sizes of each of the pools.  They're all multiples of 16 so every block is
+        // aligned well enough for any of the heap objects.
+        constexpr size_t size_classes[] = { 16, 32, 48, 64, 96, 128, 192, 256 };
+
+        constexpr size_t size_class_count = std::size(size_classes);
+        constexpr size_t largest_size_class = size_classes[size_class_count - 1];
+
+
+        // The pools get their blocks by carving up chunks of this size.
+        constexpr size_t chunk_size = 64 * 1024;
+
+
+        // Table to find the size class for an allocation, indexed by the size rounded up to the
+        // next multiple of 16.
+        constexpr auto size_class_table = []()
+            {
+                std::array<uint8_t, (largest_size_class / 16) + 1> table {};
+                size_t size_class = 0;
+
+                for (size_t i = 0; i < table.size(); ++i)
+                {
+                    while (size_classes[size_class] < i * 16)
+                    {
+                        ++size_class;
+                    }
+
+                    table[i] = static_cast<uint8_t>(size_class);
+                }
+
+                return table;
+            }();
+
+
+        // Free blocks are kept in a list threaded through the blocks themselves.
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+
+        struct Pool
+        {
+            FreeBlock* free_list;
+            int64_t blocks_in_use;
+            size_t blocks_free;
+            size_t chunk_count;
+        };
+
+
+        // Each thread gets it's own set of pools.  They're kept trivial so that the allocation
+        // paths don't pay for a thread_local constructor check, the PoolRelease below takes care
+        // of them when the thread exits.
+        thread_local Pool pools[size_class_count];
+
+
+        // The pools of the threads that have exited.  Blocks from an exiting thread's chunks may
+        // still be in use elsewhere, so instead of freeing the chunks the pools are kept here
+        // until another thread runs out of blocks and takes them over.
+        std::mutex released_pools_lock;
+        Pool released_pools[size_class_count];
+
+
+        // Hand all of the calling thread's pools over to the released pools.
+        void release_thread_pools() noexcept
+        {
+            std::lock_guard<std::mutex> lock(released_pools_lock);
+
+            for (size_t i = 0; i < size_class_count; ++i)
+            {
+                auto& pool = pools[i];
+                auto& released = released_pools[i];
+
+                if (pool.free_list != nullptr)
+                {
+                    auto last = pool.free_list;
+
+                    while (last->next != nullptr)
+                    {
+                        last = last->next;
+                    }
+
+                    last->next = released.free_list;
+                    released.free_list = pool.free_list;
+                }
+
+                released.blocks_in_use += pool.blocks_in_use;
+                released.blocks_free += pool.blocks_free;
+                released.chunk_count += pool.chunk_count;
+
+                pool = Pool {};
+            }
+        }
+
+
+        // Releases the thread's pools when it exits.  It's only touched when a thread's pool goes
+        // from empty to holding blocks, so a thread that never allocated has nothing to release.
+        struct PoolRelease
+        {
+            bool has_blocks = false;
+
+            ~PoolRelease()
+            {
+                if (has_blocks)
+                {
+                    release_thread_pools();
+                }
+            }
+        };
+
+
+        thread_local PoolRelease pool_release;
+
+
+        size_t size_class_index(size_t size) noexcept
+        {
+            return size_class_table[(size + 15) / 16];
+        }
+
+
+        // Refill an empty pool, taking over the blocks left by exited threads if there are any,
+        // otherwise carving up a new chunk.
+        void refill_pool(Pool& pool, size_t index)
+        {
+            pool_release.has_blocks = true;
+
+            {
+                std::lock_guard<std::mutex> lock(released_pools_lock);
+                auto& released = released_pools[index];
+
+                if (released.free_list != nullptr)
+                {
+                    pool.blocks_in_use += released.blocks_in_use;
+                    pool.blocks_free += released.blocks_free;
+                    pool.chunk_count += released.chunk_count;
+                    pool.free_list = released.free_list;
+
+                    released = Pool {};
+                    return;
+                }
+            }
+
+            auto block_size = size_classes[index];
+            auto chunk = static_cast<unsigned char*>(::operator new(chunk_size));
+            auto block_count = chunk_size / block_size;
+
+            // Thread the list back to front so that the blocks are handed out in address order.
+            for (size_t i = block_count; i > 0; --i)
+            {
+                auto block = reinterpret_cast<FreeBlock*>(chunk + ((i - 1) * block_size));
+
+                block->next = pool.free_list;
+                pool.free_list = block;
+            }
+
+            pool.blocks_free += block_count;
+            ++pool.chunk_count;
+        }
+
+
+    }
+
+
+    void* pool_allocate(size_t size)
+    {
+        if (size > largest_size_class)
+        {
+            return ::operator new(size);
+        }
+
+        auto index = size_class_index(size);
+        auto& pool = pools[index];
+
+        if (pool.free_list == nullptr)
+        {
+            refill_pool(pool, index);
+        }
+
+        auto block = pool.free_list;
+
+        pool.free_list = block->next;
+        --pool.blocks_free;
+        ++pool.blocks_in_use;
+
+        return block;
+    }
+
+
+    void pool_free(void* block, size_t size) noexcept
+    {
+        if (block == nullptr)
+        {
+            return;
+        }
+
+        if (size > largest_size_class)
+        {
+            ::operator delete(block);
+            return;
+        }
+
+        auto& pool = pools[size_class_index(size)];
+        auto free_block = static_cast<FreeBlock*>(block);
+
+        if (pool.free_list == nullptr)
+        {
+            pool_release.has_blocks = true;
+        }
+
+        free_block->next = pool.free_list;
+        pool.free_list = free_block;
+
+        ++pool.blocks_free;
+        --pool.blocks_in_use;
+    }
+
+
+    std::vector<PoolStatistics> pool_statistics()
+    {
+        std::vector<PoolStatistics> statistics;
+
+        statistics.reserve(size_class_count);
+
+        for (size_t i = 0; i < size_class_count; ++i)
+        {
+            statistics.push_back({
+                    .block_size = size_classes[i],
+                    .blocks_in_use = pools[i].blocks_in_use,
+                    .blocks_free = pools[i].blocks_free,
+                    .chunk_count = pools[i].chunk_count
+                });
+        }
+
+        return statistics;
+    }
+
+
+}
@@ -0,0 +1,39 @@
+
+#pragma once
+
+
+
+namespace sorth::run_time::data_structures
+{
+
+
+    // The run-time's heap objects, and the small blocks of memory they own, are allocated from
+    // pools kept by each thread.  There is a pool for each of a handful of size classes, so the hot
+    // allocation paths are a free list pop and push that never touch the malloc locks.  Anything
+    // larger than the biggest size class goes straight to operator new.
+    //
+    // A block can be freed on a different thread than the one that allocated it, it simply joins
+    // the freeing thread's pool.  Because of this the memory held by the pools is never given back
+    // to the system.  Instead when a thread exits it's pools are handed on to the next threads
+    // that run out of blocks.
+    void* pool_allocate(size_t size);
+
+    // Return a block to the pools, size must be the same size the block was allocated with.
+    void pool_free(void* block, size_t size) noexcept;
+
+
+    // How full one of the calling thread's pools are.
+    struct PoolStatistics
+    {
+        size_t block_size;      // The size of the blocks in this pool.
+        int64_t blocks_in_use;  // Blocks allocated less the blocks freed by the pool.
+        size_t blocks_free;     // Blocks waiting in the pool's free list.
+        size_t chunk_count;     // How many chunks of memory the pool has carved it's blocks from.
+    };
+
+
+    // Get the occupancy of each of the calling thread's pools, smallest block size first.
+    std::vector<PoolStatistics> pool_statistics();
+
+
+}
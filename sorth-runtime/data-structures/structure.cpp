@@ -75,7 +75,7 @@ namespace sorth::run_time::data_structures
     uint8_t make_new_struct(const StrucureDefinitionPtr& definition_ptr, Value& output)
     {
         // Create an instance of the structure
-        StructurePtr new_struct = std::make_shared<Structure>();
+        StructurePtr new_struct = make_ref<Structure>();
 
         new_struct->definition = definition_ptr;
         new_struct->fields.resize(definition_ptr->field_names.size());
@@ -83,9 +83,9 @@ namespace sorth::run_time::data_structures
 
         // Create an array of default values for the structure.  Then call the user's initialization
         // word to get the actual values.
-        Value default_array = std::make_shared<Array>(definition_ptr->field_names.size());
+        Value default_array = make_ref<Array>(definition_ptr->field_names.size());
 
-        stack_push(&default_array);
+        stack_push_move(&default_array);
         auto result = definition_ptr->init();
 
         // Make sure that the call to the word was successful.
@@ -125,7 +125,7 @@ namespace sorth::run_time::data_structures
 
     Value Structure::deep_copy() const noexcept
     {
-        StructurePtr result = std::make_shared<Structure>();
+        StructurePtr result = make_ref<Structure>();
 
         result->definition = definition;
         result->fields.reserve(fields.size());
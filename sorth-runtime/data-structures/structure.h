@@ -30,7 +30,7 @@ namespace sorth::run_time::data_structures
     using StrucureDefinitionPtr = std::shared_ptr<StructureDefinition>;
 
 
-    class Structure
+    class Structure : public HeapObject
     {
         public:
             StrucureDefinitionPtr definition;   // Reference of the base definition.
@@ -49,45 +49,48 @@ namespace sorth::run_time::data_structures
 
     std::ostream& operator <<(std::ostream& stream, const Value& value) noexcept
     {
-        if (std::holds_alternative<None>(value.value))
+        switch (value.type)
         {
-            stream << "none";
-        }
-        else if (std::holds_alternative<int64_t>(value.value))
-        {
-            stream << std::get<int64_t>(value.value);
-        }
-        else if (std::holds_alternative<double>(value.value))
-        {
-            stream << std::get<double>(value.value);
-        }
-        else if (std::holds_alternative<bool>(value.value))
-        {
-            stream << (std::get<bool>(value.value) ? "true" : "false");
-        }
-        else if (std::holds_alternative<std::string>(value.value))
-        {
-            stream << std::get<std::string>(value.value);
-        }
-        else if (std::holds_alternative<StructurePtr>(value.value))
-        {
-            stream << std::get<StructurePtr>(value.value);
-        }
-        else if (std::holds_alternative<ArrayPtr>(value.value))
-        {
-            stream << std::get<ArrayPtr>(value.value);
-        }
-        else if (std::holds_alternative<HashTablePtr>(value.value))
-        {
-            stream << std::get<HashTablePtr>(value.value);
-        }
-        else if (std::holds_alternative<ByteBufferPtr>(value.value))
-        {
-            stream << std::get<ByteBufferPtr>(value.value);
-        }
-        else
-        {
-            stream << "<unknown-value-type>";
+            case Value::Type::none:
+                stream << "none";
+                break;
+
+            case Value::Type::int_value:
+                stream << value.payload.int_value;
+                break;
+
+            case Value::Type::double_value:
+                stream << value.payload.double_value;
+                break;
+
+            case Value::Type::bool_value:
+                stream << (value.payload.bool_value ? "true" : "false");
+                break;
+
+            case Value::Type::string:
+            case Value::Type::short_string:
+                stream << value.get_string();
+                break;
+
+            case Value::Type::structure:
+                stream << value.get_structure();
+                break;
+
+            case Value::Type::array:
+                stream << value.get_array();
+                break;
+
+            case Value::Type::hash_table:
+                stream << value.get_hash_table();
+                break;
+
+            case Value::Type::byte_buffer:
+                stream << value.get_byte_buffer();
+                break;
+
+            default:
+                stream << "<unknown-value-type>";
+                break;
         }
 
         return stream;
@@ -96,138 +99,196 @@ namespace sorth::run_time::data_structures
 
     std::strong_ordering operator <=>(const Value& lhs, const Value& rhs) noexcept
     {
-        if (lhs.value.index() != rhs.value.index())
+        if (lhs.sort_type() != rhs.sort_type())
         {
-            return lhs.value.index() <=> rhs.value.index();
+            return lhs.sort_type() <=> rhs.sort_type();
         }
 
-        if (std::holds_alternative<None>(lhs.value))
+        switch (lhs.sort_type())
         {
-            return std::strong_ordering::equal;
-        }
+            case Value::Type::none:
+                return std::strong_ordering::equal;
 
-        if (std::holds_alternative<int64_t>(lhs.value))
-        {
-            return std::get<int64_t>(lhs.value) <=> std::get<int64_t>(rhs.value);
-        }
+            case Value::Type::int_value:
+                return lhs.payload.int_value <=> rhs.payload.int_value;
 
-        if (std::holds_alternative<double>(lhs.value))
-        {
-            auto lhs_value = std::get<double>(lhs.value);
-            auto rhs_value = std::get<double>(rhs.value);
+            case Value::Type::double_value:
+                if (lhs.payload.double_value > rhs.payload.double_value)
+                {
+                    return std::strong_ordering::greater;
+                }
+                else if (lhs.payload.double_value < rhs.payload.double_value)
+                {
+                    return std::strong_ordering::less;
+                }
 
-            if (lhs_value > rhs_value)
-            {
-                return std::strong_ordering::greater;
-            }
-            else if (lhs_value < rhs_value)
-            {
-                return std::strong_ordering::less;
-            }
+                return std::strong_ordering::equal;
 
-            return std::strong_ordering::equal;
-        }
+            case Value::Type::bool_value:
+                return lhs.payload.bool_value <=> rhs.payload.bool_value;
 
-        if (std::holds_alternative<bool>(lhs.value))
-        {
-            return std::get<bool>(lhs.value) <=> std::get<bool>(rhs.value);
-        }
+            case Value::Type::string:
+                return lhs.get_string() <=> rhs.get_string();
 
-        if (std::holds_alternative<std::string>(lhs.value))
-        {
-            return std::get<std::string>(lhs.value) <=> std::get<std::string>(rhs.value);
-        }
+            // Structures are compared by identity.
+            case Value::Type::structure:
+                return std::compare_three_way()(lhs.payload.object, rhs.payload.object);
 
-        if (std::holds_alternative<StructurePtr>(lhs.value))
-        {
-            return std::get<StructurePtr>(lhs.value) <=> std::get<StructurePtr>(rhs.value);
-        }
+            case Value::Type::array:
+                return lhs.get_array() <=> rhs.get_array();
 
-        if (std::holds_alternative<ArrayPtr>(lhs.value))
-        {
-            return std::get<ArrayPtr>(lhs.value) <=> std::get<ArrayPtr>(rhs.value);
-        }
+            case Value::Type::hash_table:
+                return lhs.get_hash_table() <=> rhs.get_hash_table();
 
-        if (std::holds_alternative<HashTablePtr>(lhs.value))
-        {
-            return std::get<HashTablePtr>(lhs.value) <=> std::get<HashTablePtr>(rhs.value);
-        }
+            case Value::Type::byte_buffer:
+                return lhs.get_byte_buffer() <=> rhs.get_byte_buffer();
 
-        if (std::holds_alternative<ByteBufferPtr>(lhs.value))
-        {
-            return std::get<ByteBufferPtr>(lhs.value) <=> std::get<ByteBufferPtr>(rhs.value);
+            default:
+                break;
         }
 
         return std::strong_ordering::equal;
     }
 
 
+    StringObject::StringObject(size_t new_length) noexcept
+    : length(new_length)
+    {
+    }
+
+
+    StringObject* StringObject::create(std::string_view text)
+    {
+        void* block = pool_allocate(sizeof(StringObject) + text.size());
+        auto object = new (block) StringObject(text.size());
+
+        std::memcpy(static_cast<char*>(block) + sizeof(StringObject), text.data(), text.size());
+
+        return object;
+    }
+
+
+    // The size of the block depends on the length of the string, so it's worked out before the
+    // object is destroyed.
+    void StringObject::operator delete(StringObject* object, std::destroying_delete_t) noexcept
+    {
+        auto size = sizeof(StringObject) + object->length;
+
+        object->~StringObject();
+        pool_free(object, size);
+    }
+
+
+    std::string_view StringObject::text() const noexcept
+    {
+        auto text = reinterpret_cast<const char*>(this) + sizeof(StringObject);
+
+        return std::string_view(text, length);
+    }
+
+
     thread_local size_t Value::value_format_indent;
 
 
     Value::Value() noexcept
-    : value(None{})
+    : type(Type::none)
     {
+        payload.int_value = 0;
     }
 
 
     Value::Value(int64_t new_value) noexcept
-    : value(new_value)
+    : type(Type::int_value)
     {
+        payload.int_value = new_value;
     }
 
 
     Value::Value(double new_value) noexcept
-    : value(new_value)
+    : type(Type::double_value)
     {
+        payload.double_value = new_value;
     }
 
 
     Value::Value(bool new_value) noexcept
-    : value(new_value)
+    : type(Type::bool_value)
     {
+        // Clear the whole payload first so that the bytes past the bool are predictable.
+        payload.int_value = 0;
+        payload.bool_value = new_value;
     }
 
 
     Value::Value(const char* new_value) noexcept
-    : value(std::string(new_value))
     {
+        set_string(new_value);
     }
 
 
     Value::Value(const std::string& new_value) noexcept
-    : value(new_value)
     {
+        set_string(new_value);
     }
 
 
     Value::Value(const StructurePtr& new_value) noexcept
-    : value(new_value)
     {
+        set_object(Type::structure, new_value.get());
     }
 
 
     Value::Value(const ArrayPtr& new_value) noexcept
-    : value(new_value)
     {
+        set_object(Type::array, new_value.get());
     }
 
 
     Value::Value(const HashTablePtr& new_value) noexcept
-    : value(new_value)
     {
+        set_object(Type::hash_table, new_value.get());
     }
 
 
     Value::Value(const ByteBufferPtr& new_value) noexcept
-    : value(new_value)
     {
+        set_object(Type::byte_buffer, new_value.get());
+    }
+
+
+    // Copies of a value share the same heap object, so copying a value is always just copying
+    // it's bytes and bumping the object's reference count.
+    Value::Value(const Value& other) noexcept
+    {
+        std::memcpy(static_cast<void*>(this), static_cast<const void*>(&other), sizeof(Value));
+
+        if (is_object() && payload.object)
+        {
+            payload.object->add_reference();
+        }
+    }
+
+
+    Value::Value(Value&& other) noexcept
+    {
+        std::memcpy(static_cast<void*>(this), static_cast<const void*>(&other), sizeof(Value));
+
+        other.payload.int_value = 0;
+        other.type = Type::none;
+    }
+
+
+    Value::~Value() noexcept
+    {
+        release();
     }
 
 
-    Value& Value::operator =(const None& new_value) noexcept
+    // All of the assignments build the new value first and then swap it in, so that a value that
+    // is being assigned something held inside of it's own current object is still safe.
+    Value& Value::operator =(const None&) noexcept
     {
-        value = new_value;
+        Value().swap(*this);
 
         return *this;
     }
@@ -235,7 +296,7 @@ namespace sorth::run_time::data_structures
 
     Value& Value::operator =(int64_t new_value) noexcept
     {
-        value = new_value;
+        Value(new_value).swap(*this);
 
         return *this;
     }
@@ -243,7 +304,7 @@ namespace sorth::run_time::data_structures
 
     Value& Value::operator =(double new_value) noexcept
     {
-        value = new_value;
+        Value(new_value).swap(*this);
 
         return *this;
     }
@@ -251,7 +312,7 @@ namespace sorth::run_time::data_structures
 
     Value& Value::operator =(bool new_value) noexcept
     {
-        value = new_value;
+        Value(new_value).swap(*this);
 
         return *this;
     }
@@ -259,7 +320,7 @@ namespace sorth::run_time::data_structures
 
     Value& Value::operator =(const char* new_value) noexcept
     {
-        value = std::string(new_value);
+        Value(new_value).swap(*this);
 
         return *this;
     }
@@ -267,7 +328,15 @@ namespace sorth::run_time::data_structures
 
     Value& Value::operator =(const std::string& new_value) noexcept
     {
-        value = new_value;
+        Value(new_value).swap(*this);
+
+        return *this;
+    }
+
+
+    Value& Value::operator =(const StructurePtr& new_value) noexcept
+    {
+        Value(new_value).swap(*this);
 
         return *this;
     }
@@ -275,86 +344,155 @@ namespace sorth::run_time::data_structures
 
     Value& Value::operator =(const ArrayPtr& new_value) noexcept
     {
-        value = new_value;
+        Value(new_value).swap(*this);
+
+        return *this;
+    }
+
+
+    Value& Value::operator =(const HashTablePtr& new_value) noexcept
+    {
+        Value(new_value).swap(*this);
+
+        return *this;
+    }
+
+
+    Value& Value::operator =(const ByteBufferPtr& new_value) noexcept
+    {
+        Value(new_value).swap(*this);
+
+        return *this;
+    }
+
+
+    Value& Value::operator =(const Value& other) noexcept
+    {
+        Value(other).swap(*this);
 
         return *this;
     }
 
 
+    Value& Value::operator =(Value&& other) noexcept
+    {
+        Value(std::move(other)).swap(*this);
+
+        return *this;
+    }
+
+
+    void Value::swap(Value& other) noexcept
+    {
+        unsigned char bytes[sizeof(Value)];
+
+        std::memcpy(bytes, static_cast<const void*>(this), sizeof(Value));
+        std::memcpy(static_cast<void*>(this), static_cast<const void*>(&other), sizeof(Value));
+        std::memcpy(static_cast<void*>(&other), bytes, sizeof(Value));
+    }
+
+
     Value Value::deep_copy() const noexcept
     {
         if (is_structure())
         {
-            return std::get<StructurePtr>(value)->deep_copy();
+            return get_structure()->deep_copy();
         }
         else if (is_array())
         {
-            return std::get<ArrayPtr>(value)->deep_copy();
+            return get_array()->deep_copy();
         }
         else if (is_hash_table())
         {
-            return std::get<HashTablePtr>(value)->deep_copy();
+            return get_hash_table()->deep_copy();
         }
         else if (is_byte_buffer())
         {
-            return std::get<ByteBufferPtr>(value)->deep_copy();
+            return get_byte_buffer()->deep_copy();
         }
 
         return *this;
     }
 
 
+    const ValueLayout& Value::layout() noexcept
+    {
+        static const ValueLayout value_layout = []()
+            {
+                ValueLayout layout {};
+
+                layout.size = sizeof(Value);
+                layout.tag_offset = offsetof(Value, type);
+                layout.data_offset = offsetof(Value, payload);
+
+                layout.none_tag = static_cast<uint8_t>(Type::none);
+                layout.int_tag = static_cast<uint8_t>(Type::int_value);
+                layout.double_tag = static_cast<uint8_t>(Type::double_value);
+                layout.bool_tag = static_cast<uint8_t>(Type::bool_value);
+
+                layout.scalar_tag_mask =   (1ull << layout.none_tag)
+                                         | (1ull << layout.int_tag)
+                                         | (1ull << layout.double_tag)
+                                         | (1ull << layout.bool_tag);
+
+                return layout;
+            }();
+
+        return value_layout;
+    }
+
+
     bool Value::is_none() const noexcept
     {
-        return std::holds_alternative<None>(value);
+        return type == Type::none;
     }
 
 
     bool Value::is_int() const noexcept
     {
-        return std::holds_alternative<int64_t>(value);
+        return type == Type::int_value;
     }
 
 
     bool Value::is_double() const noexcept
     {
-        return std::holds_alternative<double>(value);
+        return type == Type::double_value;
     }
 
 
     bool Value::is_bool() const noexcept
     {
-        return std::holds_alternative<bool>(value);
+        return type == Type::bool_value;
     }
 
 
     bool Value::is_string() const noexcept
     {
-        return std::holds_alternative<std::string>(value);
+        return (type == Type::string) || (type == Type::short_string);
     }
 
 
     bool Value::is_structure() const noexcept
     {
-        return std::holds_alternative<StructurePtr>(value);
+        return type == Type::structure;
     }
 
 
     bool Value::is_array() const noexcept
     {
-        return std::holds_alternative<ArrayPtr>(value);
+        return type == Type::array;
     }
 
 
     bool Value::is_hash_table() const noexcept
     {
-        return std::holds_alternative<HashTablePtr>(value);
+        return type == Type::hash_table;
     }
 
 
     bool Value::is_byte_buffer() const noexcept
     {
-        return std::holds_alternative<ByteBufferPtr>(value);
+        return type == Type::byte_buffer;
     }
 
 
@@ -397,14 +535,14 @@ namespace sorth::run_time::data_structures
 
         if (is_double())
         {
-            return static_cast<int64_t>(std::get<double>(value));
+            return static_cast<int64_t>(payload.double_value);
         }
         else if (is_bool())
         {
-            return std::get<bool>(value) ? 1 : 0;
+            return payload.bool_value ? 1 : 0;
         }
 
-        return std::get<int64_t>(value);
+        return payload.int_value;
     }
 
 
@@ -417,14 +555,14 @@ namespace sorth::run_time::data_structures
 
         if (is_int())
         {
-            return static_cast<double>(std::get<int64_t>(value));
+            return static_cast<double>(payload.int_value);
         }
         else if (is_bool())
         {
-            return std::get<bool>(value) ? 1.0 : 0.0;
+            return payload.bool_value ? 1.0 : 0.0;
         }
 
-        return std::get<double>(value);
+        return payload.double_value;
     }
 
 
@@ -437,25 +575,30 @@ namespace sorth::run_time::data_structures
 
         if (is_int())
         {
-            return std::get<int64_t>(value) != 0;
+            return payload.int_value != 0;
         }
         else if (is_double())
         {
-            return std::get<double>(value) != 0.0;
+            return payload.double_value != 0.0;
         }
 
-        return std::get<bool>(value);
+        return payload.bool_value;
     }
 
 
-    const std::string& Value::get_string() const
+    std::string_view Value::get_string() const
     {
+        if (type == Type::short_string)
+        {
+            return std::string_view(reinterpret_cast<const char*>(this), short_string_length);
+        }
+
         if (!is_string())
         {
             throw std::runtime_error("Value is not a string.");
         }
 
-        return std::get<std::string>(value);
+        return static_cast<StringObject*>(payload.object)->text();
     }
 
 
@@ -463,7 +606,7 @@ namespace sorth::run_time::data_structures
     {
         if (is_string())
         {
-            return get_string();
+            return std::string(get_string());
         }
 
         std::stringstream stream;
@@ -481,7 +624,7 @@ namespace sorth::run_time::data_structures
             throw std::runtime_error("Value is not a structure.");
         }
 
-        return std::get<StructurePtr>(value);
+        return get_object<Structure>();
     }
 
 
@@ -492,7 +635,7 @@ namespace sorth::run_time::data_structures
             throw std::runtime_error("Value is not an array.");
         }
 
-        return std::get<ArrayPtr>(value);
+        return get_object<Array>();
     }
 
 
@@ -503,7 +646,7 @@ namespace sorth::run_time::data_structures
             throw std::runtime_error("Value is not a hash table.");
         }
 
-        return std::get<HashTablePtr>(value);
+        return get_object<HashTable>();
     }
 
 
@@ -514,7 +657,78 @@ namespace sorth::run_time::data_structures
             throw std::runtime_error("Value is not a byte buffer.");
         }
 
-        return std::get<ByteBufferPtr>(value);
+        return get_object<ByteBuffer>();
+    }
+
+
+    bool Value::is_object() const noexcept
+    {
+        return (type >= Type::string) && (type <= Type::byte_buffer);
+    }
+
+
+    Value::Type Value::sort_type() const noexcept
+    {
+        return type == Type::short_string ? Type::string : type;
+    }
+
+
+    // Short strings are copied into the value itself, starting at the first byte of the payload
+    // and running into the tail bytes that follow it.
+    void Value::set_string(std::string_view text) noexcept
+    {
+        static_assert(offsetof(Value, payload) == 0);
+        static_assert(offsetof(Value, short_string_tail) == sizeof(Payload));
+        static_assert(offsetof(Value, short_string_length) == short_string_capacity);
+
+        if (text.size() <= short_string_capacity)
+        {
+            std::memcpy(static_cast<void*>(this), text.data(), text.size());
+
+            short_string_length = static_cast<uint8_t>(text.size());
+            type = Type::short_string;
+        }
+        else
+        {
+            set_object(Type::string, StringObject::create(text));
+        }
+    }
+
+
+    void Value::set_object(Type new_type, HeapObject* new_object) noexcept
+    {
+        type = new_type;
+        payload.object = new_object;
+
+        if (new_object)
+        {
+            new_object->add_reference();
+        }
+    }
+
+
+    // Drop this value's reference to it's heap object, freeing the object if this was the last
+    // one.  The object is freed through it's real type so that it's destructor is run.
+    void Value::release() noexcept
+    {
+        if (   !is_object()
+            || !payload.object
+            || !payload.object->release_reference())
+        {
+            return;
+        }
+
+        switch (type)
+        {
+            case Type::string:      delete static_cast<StringObject*>(payload.object); break;
+            case Type::structure:   delete static_cast<Structure*>(payload.object);    break;
+            case Type::array:       delete static_cast<Array*>(payload.object);        break;
+            case Type::hash_table:  delete static_cast<HashTable*>(payload.object);    break;
+            case Type::byte_buffer: delete static_cast<ByteBuffer*>(payload.object);   break;
+
+            default:
+                break;
+        }
     }
 
 
@@ -527,42 +741,42 @@ namespace sorth::run_time::data_structures
 
         if (is_int())
         {
-            return std::hash<int64_t>()(std::get<int64_t>(value));
+            return std::hash<int64_t>()(payload.int_value);
         }
 
         if (is_double())
         {
-            return std::hash<double>()(std::get<double>(value));
+            return std::hash<double>()(payload.double_value);
         }
 
         if (is_bool())
         {
-            return std::hash<bool>()(std::get<bool>(value));
+            return std::hash<bool>()(payload.bool_value);
         }
 
         if (is_string())
         {
-            return std::hash<std::string>()(std::get<std::string>(value));
+            return std::hash<std::string_view>()(get_string());
         }
 
         if (is_structure())
         {
-            return std::get<StructurePtr>(value)->hash();
+            return static_cast<Structure*>(payload.object)->hash();
         }
 
         if (is_array())
         {
-            return std::get<ArrayPtr>(value)->hash();
+            return static_cast<Array*>(payload.object)->hash();
         }
 
         if (is_hash_table())
         {
-            return std::get<HashTablePtr>(value)->hash();
+            return static_cast<HashTable*>(payload.object)->hash();
         }
 
         if (is_byte_buffer())
         {
-            return std::get<ByteBufferPtr>(value)->hash();
+            return static_cast<ByteBuffer*>(payload.object)->hash();
         }
 
         return 0;
@@ -13,41 +13,100 @@ namespace sorth::run_time::data_structures
 
 
     class Structure;
-    using StructurePtr = std::shared_ptr<Structure>;
+    using StructurePtr = Ref<Structure>;
 
 
     class Array;
-    using ArrayPtr = std::shared_ptr<Array>;
+    using ArrayPtr = Ref<Array>;
 
 
     class HashTable;
-    using HashTablePtr = std::shared_ptr<HashTable>;
+    using HashTablePtr = Ref<HashTable>;
 
 
     class ByteBuffer;
-    using ByteBufferPtr = std::shared_ptr<ByteBuffer>;
+    using ByteBufferPtr = Ref<ByteBuffer>;
+
+
+    // Describes where the type tag and the scalar payload of a Value live in memory.  The compiler
+    // uses this to generate code that reads and writes int, float, and bool values in place
+    // without having to call into the run-time.
+    struct ValueLayout
+    {
+        size_t size;              // The full size of a Value.
+        size_t tag_offset;        // Offset of the one byte type tag.
+        size_t data_offset;       // Offset of the int64_t, double, or bool payload.
+
+        uint8_t none_tag;         // Tag values for each of the scalar types.
+        uint8_t int_tag;
+        uint8_t double_tag;
+        uint8_t bool_tag;
+
+        uint64_t scalar_tag_mask; // Bit mask of the tags of types that don't own any memory.
+    };
+
+
+    // The text of a string that's too long to be held inside of a value.  Strings are never
+    // changed once they've been created, so all of the copies of a value share the one block.  The
+    // characters are allocated in the same block, directly after the object.
+    class StringObject : public HeapObject
+    {
+        private:
+            size_t length;
+
+        private:
+            StringObject(size_t new_length) noexcept;
+
+        public:
+            static StringObject* create(std::string_view text);
+            static void operator delete(StringObject* object, std::destroying_delete_t) noexcept;
+
+        public:
+            std::string_view text() const noexcept;
+    };
 
 
     class Value
     {
         private:
-            using ValueType = std::variant<None,
-                                           int64_t,
-                                           double,
-                                           bool,
-                                           std::string,
-                                           StructurePtr,
-                                           ArrayPtr,
-                                           HashTablePtr,
-                                           ByteBufferPtr>;
+            // The types of value, in the order that values of different types sort in.  Short strings
+            // sort along with the other strings.
+            enum class Type : uint8_t
+            {
+                none,
+                int_value,
+                double_value,
+                bool_value,
+                string,
+                structure,
+                array,
+                hash_table,
+                byte_buffer,
+                short_string
+            };
+
+            static constexpr size_t short_string_capacity = 14;
+
+            union Payload
+            {
+                int64_t int_value;
+                double double_value;
+                bool bool_value;
+                HeapObject* object;
+            };
 
         public:
             static thread_local size_t value_format_indent;
 
         private:
-            ValueType value;
+            Payload payload;
+            char short_string_tail[short_string_capacity - sizeof(Payload)];
+            uint8_t short_string_length;
+            Type type;
 
         public:
+            // The string constructors and assignments allocate the text of strings too long to
+            // keep inline.  They stay noexcept, running out of memory there is treated as fatal.
             Value() noexcept;
             Value(int64_t new_value) noexcept;
             Value(double new_value) noexcept;
@@ -58,9 +117,9 @@ namespace sorth::run_time::data_structures
             Value(const ArrayPtr& new_value) noexcept;
             Value(const HashTablePtr& new_value) noexcept;
             Value(const ByteBufferPtr& new_value) noexcept;
-            Value(const Value& other) noexcept = default;
-            Value(Value&& other) noexcept = default;
-            ~Value() noexcept = default;
+            Value(const Value& other) noexcept;
+            Value(Value&& other) noexcept;
+            ~Value() noexcept;
 
         public:
             Value& operator =(const None& new_value) noexcept;
@@ -73,12 +132,17 @@ namespace sorth::run_time::data_structures
             Value& operator =(const ArrayPtr& new_value) noexcept;
             Value& operator =(const HashTablePtr& new_value) noexcept;
             Value& operator =(const ByteBufferPtr& new_value) noexcept;
-            Value& operator =(const Value& other) noexcept = default;
-            Value& operator =(Value&& other) noexcept = default;
+            Value& operator =(const Value& other) noexcept;
+            Value& operator =(Value&& other) noexcept;
+
+            void swap(Value& other) noexcept;
 
         public:
             Value deep_copy() const noexcept;
 
+        public:
+            static const ValueLayout& layout() noexcept;
+
         public:
             bool is_none() const noexcept;
             bool is_int() const noexcept;
@@ -102,13 +166,26 @@ namespace sorth::run_time::data_structures
             int64_t get_int() const;
             double get_double() const;
             bool get_bool() const;
-            const std::string& get_string() const;
+            std::string_view get_string() const;
             std::string get_string_with_conversion() const noexcept;
             StructurePtr get_structure() const;
             ArrayPtr get_array() const;
             HashTablePtr get_hash_table() const;
             ByteBufferPtr get_byte_buffer() const;
 
+        private:
+            bool is_object() const noexcept;
+            Type sort_type() const noexcept;
+            void set_string(std::string_view text) noexcept;
+            void set_object(Type new_type, HeapObject* new_object) noexcept;
+            void release() noexcept;
+
+            template <typename ObjectType>
+            Ref<ObjectType> get_object() const noexcept
+            {
+                return Ref<ObjectType>(static_cast<ObjectType*>(payload.object));
+            }
+
         public:
             size_t hash() const noexcept;
             static void hash_combine(size_t& seed, size_t value) noexcept;
@@ -20,9 +20,15 @@
 #include <mutex>
 #include <condition_variable>
 #include <memory>
+#include <new>
+#include <atomic>
+#include <utility>
 #include <cstring>
 #include <filesystem>
+#include <array>
 
+#include "data-structures/pool-allocator.h"
+#include "data-structures/heap-object.h"
 #include "data-structures/value.h"
 #include "data-structures/structure.h"
 #include "data-structures/array.h"
@@ -33,4 +39,6 @@
 #include "abi/data-stack.h"
 #include "abi/structures.h"
 #include "abi/errors.h"
+#include "abi/superinstructions.h"
+#include "abi/profiling.h"
 #include "abi/words/register-words.h"
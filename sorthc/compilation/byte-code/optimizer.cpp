@@ -0,0 +1,859 @@
+
+#include "sorthc.h"
+
+
+
+namespace sorth::compilation::byte_code
+{
+
+
+    namespace
+    {
+
+
+        using Id = Instruction::Id;
+
+
+        // Does the instruction hold an offset to another instruction?
+        bool has_offset(Id id) noexcept
+        {
+            return    (id == Id::jump)
+                   || (id == Id::jump_if_zero)
+                   || (id == Id::jump_if_not_zero)
+                   || (id == Id::mark_loop_exit)
+                   || (id == Id::mark_catch);
+        }
+
+
+        // Get the absolute index of the instruction that a jump or marker refers to.
+        size_t get_target(const ByteCode& code, size_t index)
+        {
+            return index + code[index].get_value().get_int();
+        }
+
+
+        // Create a new instruction that keeps the source location of the one it's replacing.
+        Instruction replace_instruction(const Instruction& original,
+                                        Id id,
+                                        const run_time::Value& value = run_time::Value())
+        {
+            const auto& location = original.get_location();
+
+            return location ? Instruction(location.value(), id, value) : Instruction(id, value);
+        }
+
+
+        // Remove the flagged instructions from the code, fixing up the offsets of the jumps and
+        // markers that are kept.
+        void remove_instructions(ByteCode& code, const std::vector<bool>& removed)
+        {
+            std::unordered_map<size_t, ByteCode> blocks;
+
+            for (size_t i = 0; i < code.size(); ++i)
+            {
+                if (removed[i])
+                {
+                    blocks[i] = {};
+                }
+            }
+
+            splice_instructions(code, blocks);
+        }
+
+
+        // Evaluate a numeric word the same way the run-time would.  Integer division that would
+        // fault, and anything that isn't plain numbers, is left for the run-time.
+        std::optional<run_time::Value> evaluate_numeric(NumericOp op,
+                                                        const run_time::Value& a,
+                                                        const run_time::Value& b)
+        {
+            auto is_number = [](const run_time::Value& value)
+                {
+                    return value.is_int() || value.is_double();
+                };
+
+            if (!is_number(a) || !is_number(b))
+            {
+                return std::nullopt;
+            }
+
+            if (a.is_int() && b.is_int())
+            {
+                auto x = a.get_int();
+                auto y = b.get_int();
+
+                // Wrap around on overflow, just as the generated code does.
+                auto wrap = [](uint64_t value) { return static_cast<int64_t>(value); };
+
+                switch (op)
+                {
+                    case NumericOp::add:
+                        return run_time::Value(wrap((uint64_t)x + (uint64_t)y));
+
+                    case NumericOp::subtract:
+                        return run_time::Value(wrap((uint64_t)x - (uint64_t)y));
+
+                    case NumericOp::multiply:
+                        return run_time::Value(wrap((uint64_t)x * (uint64_t)y));
+
+                    case NumericOp::divide:
+                    case NumericOp::mod:
+                        if ((y == 0) || (y == -1))
+                        {
+                            return std::nullopt;
+                        }
+
+                        return run_time::Value(op == NumericOp::divide ? x / y : x % y);
+
+                    case NumericOp::equal:         return run_time::Value(x == y);
+                    case NumericOp::not_equal:     return run_time::Value(x != y);
+                    case NumericOp::greater_equal: return run_time::Value(x >= y);
+                    case NumericOp::less_equal:    return run_time::Value(x <= y);
+                    case NumericOp::greater:       return run_time::Value(x > y);
+                    case NumericOp::less:          return run_time::Value(x < y);
+                }
+
+                return std::nullopt;
+            }
+
+            // The run-time only performs mod on integers.
+            auto x = a.get_double();
+            auto y = b.get_double();
+
+            switch (op)
+            {
+                case NumericOp::add:           return run_time::Value(x + y);
+                case NumericOp::subtract:      return run_time::Value(x - y);
+                case NumericOp::multiply:      return run_time::Value(x * y);
+                case NumericOp::divide:        return run_time::Value(x / y);
+                case NumericOp::mod:           return std::nullopt;
+                case NumericOp::equal:         return run_time::Value(x == y);
+                case NumericOp::not_equal:     return run_time::Value(x != y);
+                case NumericOp::greater_equal: return run_time::Value(x >= y);
+                case NumericOp::less_equal:    return run_time::Value(x <= y);
+                case NumericOp::greater:       return run_time::Value(x > y);
+                case NumericOp::less:          return run_time::Value(x < y);
+            }
+
+            return std::nullopt;
+        }
+
+
+        // Get the truth of a constant value, if it's one the generated code would test directly.
+        std::optional<bool> evaluate_test(const run_time::Value& value)
+        {
+            if (value.is_bool())
+            {
+                return value.get_bool();
+            }
+            else if (value.is_int())
+            {
+                return value.get_int() != 0;
+            }
+            else if (value.is_double())
+            {
+                return value.get_double() != 0.0;
+            }
+
+            return std::nullopt;
+        }
+
+
+        // Can the instruction be removed from code that's never run?  Definitions and the loop,
+        // catch, and context markers describe the structure of the code so they're always kept.
+        bool is_removable(Id id) noexcept
+        {
+            switch (id)
+            {
+                case Id::read_variable:
+                case Id::write_variable:
+                case Id::execute:
+                case Id::word_index:
+                case Id::word_exists:
+                case Id::push_constant_value:
+                case Id::jump:
+                case Id::jump_if_zero:
+                case Id::jump_if_not_zero:
+                case Id::jump_loop_start:
+                case Id::jump_loop_exit:
+                    return true;
+
+                default:
+                    return false;
+            }
+        }
+
+
+        // Find the catch targets in the code, jumping to one of them runs the catch block's setup.
+        std::set<size_t> find_catch_targets(const ByteCode& code)
+        {
+            std::set<size_t> targets;
+
+            for (size_t i = 0; i < code.size(); ++i)
+            {
+                if (code[i].get_id() == Id::mark_catch)
+                {
+                    targets.insert(get_target(code, i));
+                }
+            }
+
+            return targets;
+        }
+
+
+    }
+
+
+    void splice_instructions(ByteCode& code, const std::unordered_map<size_t, ByteCode>& blocks)
+    {
+        // The new index of each instruction, or of the start of the block replacing it.
+        std::vector<int64_t> new_indices(code.size() + 1);
+        int64_t size = 0;
+
+        for (size_t i = 0; i < code.size(); ++i)
+        {
+            auto iterator = blocks.find(i);
+
+            new_indices[i] = size;
+            size += iterator != blocks.end() ? iterator->second.size() : 1;
+        }
+
+        new_indices[code.size()] = size;
+
+        ByteCode new_code;
+
+        new_code.reserve(size);
+
+        for (size_t i = 0; i < code.size(); ++i)
+        {
+            auto iterator = blocks.find(i);
+
+            if (iterator != blocks.end())
+            {
+                new_code.insert(new_code.end(), iterator->second.begin(), iterator->second.end());
+                continue;
+            }
+
+            auto instruction = code[i];
+
+            if (has_offset(instruction.get_id()))
+            {
+                auto target = std::min(get_target(code, i), code.size());
+
+                instruction.get_value() = new_indices[target] - new_indices[i];
+            }
+
+            new_code.push_back(std::move(instruction));
+        }
+
+        code = std::move(new_code);
+    }
+
+
+    void PassManager::add_pass(const std::string& name, const Pass& pass)
+    {
+        passes.push_back({ .name = name, .pass = pass, .changes = 0 });
+    }
+
+
+    void PassManager::run(ByteCode& code)
+    {
+        // One pass can open up more work for the others, but don't let a bad interaction between
+        // passes keep us here forever.
+        const size_t max_rounds = 8;
+
+        for (size_t round = 0; round < max_rounds; ++round)
+        {
+            size_t changes = 0;
+
+            for (auto& info : passes)
+            {
+                auto pass_changes = info.pass(code);
+
+                info.changes += pass_changes;
+                changes += pass_changes;
+            }
+
+            if (changes == 0)
+            {
+                break;
+            }
+        }
+    }
+
+
+    void PassManager::print_statistics(std::ostream& stream) const
+    {
+        stream << "Byte-code optimization statistics:" << std::endl;
+
+        for (const auto& info : passes)
+        {
+            stream << "    " << std::left << std::setw(28) << info.name
+                   << std::right << std::setw(8) << info.changes << std::endl;
+        }
+    }
+
+
+    PassManager create_standard_passes(const KnownWords& known_words)
+    {
+        PassManager pass_manager;
+
+        pass_manager.add_pass("constant-folding",
+                              [known_words](ByteCode& code)
+                              {
+                                  return fold_constants(code, known_words);
+                              });
+
+        pass_manager.add_pass("unreachable-code", remove_unreachable_code);
+
+        pass_manager.add_pass("dead-store-elimination",
+                              [known_words](ByteCode& code)
+                              {
+                                  return eliminate_dead_stores(code, known_words);
+                              });
+
+        pass_manager.add_pass("jump-threading", thread_jumps);
+        pass_manager.add_pass("empty-contexts", remove_empty_contexts);
+
+        return pass_manager;
+    }
+
+
+    size_t fold_constants(ByteCode& code, const KnownWords& known_words)
+    {
+        std::vector<bool> removed(code.size(), false);
+        size_t changes = 0;
+
+        // A constant can't be given to def_constant in dead code, because that instruction
+        // generates code that would follow a jump.  So if there are any constants we leave the
+        // conditional jumps alone.
+        bool can_fold_jumps = std::none_of(code.begin(),
+                                           code.end(),
+                                           [](const auto& instruction)
+                                           {
+                                               return instruction.get_id() == Id::def_constant;
+                                           });
+
+        // The indices of the constant pushes that lead up to the current instruction, with
+        // nothing in between but instructions we've already removed.
+        std::vector<size_t> constants;
+
+        for (size_t i = 0; i < code.size(); ++i)
+        {
+            auto& instruction = code[i];
+            auto id = instruction.get_id();
+
+            if (id == Id::push_constant_value)
+            {
+                constants.push_back(i);
+                continue;
+            }
+
+            auto count = constants.size();
+
+            if ((id == Id::execute) && instruction.get_value().is_int())
+            {
+                auto index = instruction.get_value().get_int();
+                auto numeric = known_words.numeric_words.find(index);
+                auto stack = known_words.stack_words.find(index);
+
+                if ((numeric != known_words.numeric_words.end()) && (count >= 2))
+                {
+                    auto a = constants[count - 2];
+                    auto b = constants[count - 1];
+
+                    auto result = evaluate_numeric(numeric->second,
+                                                   code[a].get_value(),
+                                                   code[b].get_value());
+
+                    if (result)
+                    {
+                        instruction = replace_instruction(instruction,
+                                                          Id::push_constant_value,
+                                                          result.value());
+                        removed[a] = true;
+                        removed[b] = true;
+
+                        constants.resize(count - 2);
+                        constants.push_back(i);
+
+                        ++changes;
+                        continue;
+                    }
+                }
+                else if (stack != known_words.stack_words.end())
+                {
+                    bool folded = true;
+
+                    switch (stack->second)
+                    {
+                        case StackOp::dup:
+                            if (count >= 1)
+                            {
+                                instruction = code[constants[count - 1]];
+                                constants.push_back(i);
+                            }
+                            else
+                            {
+                                folded = false;
+                            }
+                            break;
+
+                        case StackOp::drop:
+                            if (count >= 1)
+                            {
+                                removed[constants[count - 1]] = true;
+                                removed[i] = true;
+                                constants.pop_back();
+                            }
+                            else
+                            {
+                                folded = false;
+                            }
+                            break;
+
+                        case StackOp::swap:
+                            if (count >= 2)
+                            {
+                                std::swap(code[constants[count - 2]], code[constants[count - 1]]);
+                                removed[i] = true;
+                            }
+                            else
+                            {
+                                folded = false;
+                            }
+                            break;
+
+                        case StackOp::over:
+                            // a b -- b a b
+                            if (count >= 2)
+                            {
+                                std::swap(code[constants[count - 2]], code[constants[count - 1]]);
+                                instruction = code[constants[count - 2]];
+                                constants.push_back(i);
+                            }
+                            else
+                            {
+                                folded = false;
+                            }
+                            break;
+
+                        case StackOp::rot:
+                            // a b c -- c a b
+                            if (count >= 3)
+                            {
+                                auto c = code[constants[count - 1]];
+
+                                code[constants[count - 1]] = code[constants[count - 2]];
+                                code[constants[count - 2]] = code[constants[count - 3]];
+                                code[constants[count - 3]] = c;
+                                removed[i] = true;
+                            }
+                            else
+                            {
+                                folded = false;
+                            }
+                            break;
+
+                        case StackOp::nip:
+                            if (count >= 2)
+                            {
+                                removed[constants[count - 2]] = true;
+                                removed[i] = true;
+                                constants.erase(constants.end() - 2);
+                            }
+                            else
+                            {
+                                folded = false;
+                            }
+                            break;
+                    }
+
+                    if (folded)
+                    {
+                        ++changes;
+                        continue;
+                    }
+                }
+            }
+            else if (   can_fold_jumps
+                     && ((id == Id::jump_if_zero) || (id == Id::jump_if_not_zero))
+                     && (count >= 1))
+            {
+                auto test = evaluate_test(code[constants[count - 1]].get_value());
+
+                if (test)
+                {
+                    bool is_taken = (id == Id::jump_if_zero) ? !test.value() : test.value();
+
+                    removed[constants[count - 1]] = true;
+
+                    if (is_taken)
+                    {
+                        instruction = replace_instruction(instruction,
+                                                          Id::jump,
+                                                          instruction.get_value());
+                    }
+                    else
+                    {
+                        removed[i] = true;
+                    }
+
+                    ++changes;
+                }
+            }
+
+            constants.clear();
+        }
+
+        if (changes > 0)
+        {
+            remove_instructions(code, removed);
+        }
+
+        return changes;
+    }
+
+
+    size_t remove_unreachable_code(ByteCode& code)
+    {
+        // Find where each loop starts and ends, the loop jumps refer to their innermost loop.
+        std::vector<std::pair<size_t, size_t>> loop_bounds(code.size(), { 0, 0 });
+        std::vector<size_t> loop_markers;
+
+        for (size_t i = 0; i < code.size(); ++i)
+        {
+            auto id = code[i].get_id();
+
+            if (id == Id::mark_loop_exit)
+            {
+                loop_markers.push_back(i);
+            }
+            else if ((id == Id::unmark_loop_exit) && !loop_markers.empty())
+            {
+                loop_markers.pop_back();
+            }
+            else if (   ((id == Id::jump_loop_start) || (id == Id::jump_loop_exit))
+                     && !loop_markers.empty())
+            {
+                auto marker = loop_markers.back();
+
+                loop_bounds[i] = { marker + 1, get_target(code, marker) };
+            }
+        }
+
+        // Walk the code from the start, following every way control can flow.  Errors raised
+        // within a catch block flow to the catch target, so the mark_catch refers to it too.
+        std::vector<bool> reachable(code.size(), false);
+        std::vector<size_t> work_list = { 0 };
+
+        auto add = [&](size_t index)
+            {
+                if ((index < code.size()) && !reachable[index])
+                {
+                    reachable[index] = true;
+                    work_list.push_back(index);
+                }
+            };
+
+        if (code.empty())
+        {
+            return 0;
+        }
+
+        reachable[0] = true;
+
+        while (!work_list.empty())
+        {
+            auto i = work_list.back();
+            work_list.pop_back();
+
+            switch (code[i].get_id())
+            {
+                case Id::jump:
+                    add(get_target(code, i));
+                    break;
+
+                case Id::jump_loop_start:
+                    add(loop_bounds[i].first);
+                    break;
+
+                case Id::jump_loop_exit:
+                    add(loop_bounds[i].second);
+                    break;
+
+                case Id::jump_if_zero:
+                case Id::jump_if_not_zero:
+                case Id::mark_loop_exit:
+                case Id::mark_catch:
+                    add(get_target(code, i));
+                    add(i + 1);
+                    break;
+
+                default:
+                    add(i + 1);
+                    break;
+            }
+        }
+
+        std::vector<bool> removed(code.size(), false);
+        size_t changes = 0;
+
+        for (size_t i = 0; i < code.size(); ++i)
+        {
+            if (!reachable[i] && is_removable(code[i].get_id()))
+            {
+                removed[i] = true;
+                ++changes;
+            }
+        }
+
+        if (changes > 0)
+        {
+            remove_instructions(code, removed);
+        }
+
+        return changes;
+    }
+
+
+    size_t eliminate_dead_stores(ByteCode& code, const KnownWords& known_words)
+    {
+        // A dead store becomes a drop of the value that would have been written.
+        auto drop = std::find_if(known_words.stack_words.begin(),
+                                 known_words.stack_words.end(),
+                                 [](const auto& entry) { return entry.second == StackOp::drop; });
+
+        if (drop == known_words.stack_words.end())
+        {
+            return 0;
+        }
+
+        // If the word catches errors the handler could read a variable after a store that we
+        // would have otherwise thought dead.
+        if (!find_catch_targets(code).empty())
+        {
+            return 0;
+        }
+
+        // Only variables that are always read or written right away can be handled.  If one is
+        // ever left on the stack its index could be used to access it from anywhere.
+        std::unordered_map<std::string, size_t> definitions;
+
+        for (const auto& instruction : code)
+        {
+            if (instruction.get_id() == Id::def_variable)
+            {
+                ++definitions[instruction.get_value().get_string()];
+            }
+        }
+
+        auto is_reference = [&](size_t index)
+            {
+                return    (code[index].get_id() == Id::execute)
+                       && (code[index].get_value().is_string())
+                       && (definitions.find(code[index].get_value().get_string())
+                                                                        != definitions.end());
+            };
+
+        std::set<std::string> local_variables;
+
+        for (const auto& [ name, count ] : definitions)
+        {
+            if (count == 1)
+            {
+                local_variables.insert(name);
+            }
+        }
+
+        for (size_t i = 0; i < code.size(); ++i)
+        {
+            if (is_reference(i))
+            {
+                auto next = i + 1 < code.size() ? code[i + 1].get_id() : Id::jump_target;
+
+                if ((next != Id::read_variable) && (next != Id::write_variable))
+                {
+                    local_variables.erase(code[i].get_value().get_string());
+                }
+            }
+        }
+
+        std::vector<bool> removed(code.size(), false);
+        size_t changes = 0;
+
+        for (size_t i = 1; i + 1 < code.size(); ++i)
+        {
+            if (   !is_reference(i)
+                || (code[i + 1].get_id() != Id::write_variable))
+            {
+                continue;
+            }
+
+            const auto& name = code[i].get_value().get_string();
+
+            // The store that initializes a variable as it's defined is what gives the variable
+            // its type, so it's kept.
+            if (   (local_variables.find(name) == local_variables.end())
+                || (   (code[i - 1].get_id() == Id::def_variable)
+                    && (code[i - 1].get_value().get_string() == name)))
+            {
+                continue;
+            }
+
+            // Follow the straight line code after the store.  If the variable is written again
+            // before it's read, or the code ends first, the store is dead.  Any errors raised
+            // along the way leave the word, taking the variable with it.
+            bool is_dead = false;
+
+            for (size_t j = i + 2; j <= code.size(); ++j)
+            {
+                if (j == code.size())
+                {
+                    is_dead = true;
+                    break;
+                }
+
+                auto id = code[j].get_id();
+
+                if (   (id == Id::jump)
+                    || (id == Id::jump_if_zero)
+                    || (id == Id::jump_if_not_zero)
+                    || (id == Id::jump_loop_start)
+                    || (id == Id::jump_loop_exit)
+                    || (id == Id::jump_target)
+                    || (id == Id::mark_loop_exit)
+                    || (id == Id::unmark_loop_exit))
+                {
+                    break;
+                }
+
+                if (   is_reference(j)
+                    && (code[j].get_value().get_string() == name)
+                    && (j + 1 < code.size()))
+                {
+                    is_dead = code[j + 1].get_id() == Id::write_variable;
+                    break;
+                }
+            }
+
+            if (is_dead)
+            {
+                code[i] = replace_instruction(code[i],
+                                              Id::execute,
+                                              run_time::Value((int64_t)drop->first));
+                removed[i + 1] = true;
+
+                ++changes;
+            }
+        }
+
+        if (changes > 0)
+        {
+            remove_instructions(code, removed);
+        }
+
+        return changes;
+    }
+
+
+    size_t thread_jumps(ByteCode& code)
+    {
+        auto catch_targets = find_catch_targets(code);
+
+        // Find the first instruction that isn't a jump target at or after the index.  Control
+        // can't pass through a catch target without running its setup, so we stop there.
+        auto skip_targets = [&](size_t index)
+            {
+                while (   (index < code.size())
+                       && (code[index].get_id() == Id::jump_target)
+                       && (catch_targets.find(index) == catch_targets.end()))
+                {
+                    ++index;
+                }
+
+                return index;
+            };
+
+        std::vector<bool> removed(code.size(), false);
+        size_t changes = 0;
+
+        for (size_t i = 0; i < code.size(); ++i)
+        {
+            auto id = code[i].get_id();
+
+            if ((id != Id::jump) && (id != Id::jump_if_zero) && (id != Id::jump_if_not_zero))
+            {
+                continue;
+            }
+
+            // Follow the chain of jumps to where it finally ends up.
+            auto target = get_target(code, i);
+            std::set<size_t> visited = { i };
+
+            while (true)
+            {
+                auto next = skip_targets(target);
+
+                if (   (next >= code.size())
+                    || (code[next].get_id() != Id::jump)
+                    || (visited.find(next) != visited.end()))
+                {
+                    break;
+                }
+
+                visited.insert(next);
+                target = get_target(code, next);
+            }
+
+            if (target != get_target(code, i))
+            {
+                code[i].get_value() = (int64_t)target - (int64_t)i;
+                ++changes;
+            }
+
+            // A jump that lands on the next instruction anyway isn't needed.
+            if ((id == Id::jump) && (target > i) && (skip_targets(i + 1) >= target))
+            {
+                removed[i] = true;
+                ++changes;
+            }
+        }
+
+        if (changes > 0)
+        {
+            remove_instructions(code, removed);
+        }
+
+        return changes;
+    }
+
+
+    size_t remove_empty_contexts(ByteCode& code)
+    {
+        std::vector<bool> removed(code.size(), false);
+        size_t changes = 0;
+
+        for (size_t i = 0; i + 1 < code.size(); ++i)
+        {
+            if (   (code[i].get_id() == Id::mark_context)
+                && (code[i + 1].get_id() == Id::release_context))
+            {
+                removed[i] = true;
+                removed[i + 1] = true;
+
+                ++changes;
+                ++i;
+            }
+        }
+
+        if (changes > 0)
+        {
+            remove_instructions(code, removed);
+        }
+
+        return changes;
+    }
+
+
+}
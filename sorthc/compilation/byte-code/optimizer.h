@@ -0,0 +1,112 @@
+
+#pragma once
+
+
+
+namespace sorth::compilation::byte_code
+{
+
+
+    class Instruction;
+    using ByteCode = std::vector<Instruction>;
+
+
+    // The arithmetic and comparison words that the compiler understands well enough to evaluate at
+    // compile time, or to generate inline code for, when they're given numbers.
+    enum class NumericOp
+    {
+        add,
+        subtract,
+        multiply,
+        divide,
+        mod,
+        equal,
+        not_equal,
+        greater_equal,
+        less_equal,
+        greater,
+        less
+    };
+
+
+    // The native stack words that the compiler understands.
+    enum class StackOp
+    {
+        dup,
+        drop,
+        swap,
+        over,
+        rot,
+        nip
+    };
+
+
+    // The words that the byte-code optimizer knows the meaning of, by their index in the word
+    // table.
+    struct KnownWords
+    {
+        std::unordered_map<size_t, NumericOp> numeric_words;
+        std::unordered_map<size_t, StackOp> stack_words;
+    };
+
+
+    // Run a list of optimization passes over blocks of byte-code.  The passes are run in order,
+    // over and over, until none of them find anything more to do.  Each pass reports how many
+    // changes it made so that we can keep statistics on how useful they are.
+    class PassManager
+    {
+        public:
+            using Pass = std::function<size_t(ByteCode& code)>;
+
+        private:
+            struct PassInfo
+            {
+                std::string name;
+                Pass pass;
+                size_t changes;
+            };
+
+            std::vector<PassInfo> passes;
+
+        public:
+            // Add a pass to the end of the pipeline.
+            void add_pass(const std::string& name, const Pass& pass);
+
+            // Optimize the block of byte-code in place.
+            void run(ByteCode& code);
+
+            // Write out how many changes each of the passes has made so far.
+            void print_statistics(std::ostream& stream) const;
+    };
+
+
+    // Replace single instructions with blocks of code, fixing up the offsets of the jumps and
+    // markers around them.  Anything that referred to a replaced instruction now refers to the
+    // start of its block, or the next instruction if the block is empty.  Offsets within the new
+    // blocks are left as they are.
+    void splice_instructions(ByteCode& code, const std::unordered_map<size_t, ByteCode>& blocks);
+
+
+    // Create a pass manager with all of the standard byte-code optimization passes.
+    PassManager create_standard_passes(const KnownWords& known_words);
+
+
+    // Evaluate numeric and stack words that are given constant values, and resolve conditional
+    // jumps on constant tests.
+    size_t fold_constants(ByteCode& code, const KnownWords& known_words);
+
+    // Remove instructions that can never be reached.
+    size_t remove_unreachable_code(ByteCode& code);
+
+    // Drop values written to local variables that are always written again before they're read.
+    size_t eliminate_dead_stores(ByteCode& code, const KnownWords& known_words);
+
+    // Send jumps that land on other jumps straight to the final target, and remove jumps to the
+    // next instruction.
+    size_t thread_jumps(ByteCode& code);
+
+    // Remove variable contexts that have nothing in them.
+    size_t remove_empty_contexts(ByteCode& code);
+
+
+}
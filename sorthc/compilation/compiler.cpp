@@ -20,7 +20,8 @@ namespace sorth::compilation
 
 
     void Compiler::compile(const std::filesystem::path& source_path,
-                           const std::filesystem::path& output_path)
+                           const std::filesystem::path& output_path,
+                           const CodeGenOptions& options)
     {
         // Ask the runtime to byte-code compile the script.
         auto script = runtime.compile_script(source_path);
@@ -39,7 +40,7 @@ namespace sorth::compilation
         // Now that the script and it's sub-scripts are byte-code compiled, we can generate the LLVM
         // IR for it.  Then we can compile  the LLVM IR to native code into an object file that can
         // be linked with the runtime library into an executable.
-        generate_llvm_ir(runtime.get_standard_library(), script, output_path);
+        generate_llvm_ir(runtime.get_standard_library(), script, output_path, options);
     }
 
 
@@ -46,7 +46,8 @@ namespace sorth::compilation
             // Compile a Strange Forth source file and any files it includes into an executable
             // runnable by the operating system.
             void compile(const std::filesystem::path& source_path,
-                         const std::filesystem::path& output_path);
+                         const std::filesystem::path& output_path,
+                         const CodeGenOptions& options = {});
 
         private:
             // Find a file in the search paths.
@@ -91,6 +91,8 @@ namespace sorth::compilation
             llvm::AllocaInst* variable;         // The variable itself.
             llvm::AllocaInst* variable_index;   // The run-time allocated index for the variable.
             size_t block_index;                 // The index of the variable within it's block.
+            llvm::AllocaInst* unboxed_variable; // If the variable's type is known, it's value is
+                                                // kept here instead.
         };
 
 
@@ -107,6 +109,13 @@ namespace sorth::compilation
             llvm::PointerType* value_struct_ptr_type;
             llvm::ArrayType* value_struct_ptr_array_type;
 
+            // Where the tag and payload of scalar values live within the value structure.
+            sorth::run_time::data_structures::ValueLayout value_layout;
+
+            // The thread's data stack, accessed directly for scalar pushes and pops.
+            llvm::StructType* data_stack_type;
+            llvm::GlobalVariable* data_stack;
+
             // External variable functions.
             llvm::Function* initialize_variable;
             llvm::Function* free_variable;
@@ -115,15 +124,26 @@ namespace sorth::compilation
             llvm::Function* get_byte_buffer_ptr;
             llvm::Function* read_variable;
             llvm::Function* write_variable;
+            llvm::Function* replace_variable;
+            llvm::Function* copy_variable;
+            llvm::Function* take_variable;
             llvm::Function* deep_copy_variable;
 
+            // Fused versions of common word sequences.
+            llvm::Function* variable_array_read;
+            llvm::Function* variable_array_write;
+            llvm::Function* variable_hash_table_read;
+            llvm::Function* variable_hash_table_write;
+
             // External stack functions.
             llvm::Function* stack_push;
+            llvm::Function* stack_push_move;
             llvm::Function* stack_push_int;
             llvm::Function* stack_push_double;
             llvm::Function* stack_push_bool;
             llvm::Function* stack_push_string;
             llvm::Function* stack_pop;
+            llvm::Function* stack_pop_move;
             llvm::Function* stack_pop_int;
             llvm::Function* stack_pop_bool;
             llvm::Function* stack_pop_double;
@@ -172,6 +192,34 @@ namespace sorth::compilation
                             const RuntimeApi& runtime);
 
 
+        // Branch to the unlikely block if the condition is true.  Errors are rare, so the checks
+        // that lead to the error handling code tell LLVM which way they almost always go.  That
+        // way the error handling is laid out away from the main line of the program, or moved out
+        // of the function entirely.
+        llvm::BranchInst* create_unlikely_branch(llvm::IRBuilder<>& builder,
+                                                 llvm::Value* condition,
+                                                 llvm::BasicBlock* unlikely_block,
+                                                 llvm::BasicBlock* likely_block)
+        {
+            auto weights = llvm::MDBuilder(builder.getContext()).createBranchWeights(1, 2000);
+
+            return builder.CreateCondBr(condition, unlikely_block, likely_block, weights);
+        }
+
+
+        // Branch to the likely block if the condition is true, otherwise on to the rarely taken
+        // error handling block.
+        llvm::BranchInst* create_likely_branch(llvm::IRBuilder<>& builder,
+                                               llvm::Value* condition,
+                                               llvm::BasicBlock* likely_block,
+                                               llvm::BasicBlock* unlikely_block)
+        {
+            auto weights = llvm::MDBuilder(builder.getContext()).createBranchWeights(2000, 1);
+
+            return builder.CreateCondBr(condition, likely_block, unlikely_block, weights);
+        }
+
+
         // How should we pass this value to the function?
         enum class PassByType
         {
@@ -316,6 +364,32 @@ namespace sorth::compilation
         };
 
 
+        // The arithmetic and comparison words that the compiler can generate inline code for when
+        // they're given numbers.
+        using byte_code::NumericOp;
+
+
+        // How much the code generator knows about a value on the stack.
+        enum class ValueKind
+        {
+            int_value,     // An int64_t held in a register.
+            double_value,  // A double held in a register.
+            bool_value,    // An i1 held in a register.
+            value,         // A full value held in a temporary variable that we own.
+            variable,      // A reference to one of the word's local variables.
+            typed_variable // A reference to one of the word's unboxed local variables.
+        };
+
+
+        // A version of a Forth word generated for the types of the values it's called with.
+        struct WordSpecialization
+        {
+            size_t word_index;               // The word being specialized.
+            std::vector<ValueKind> inputs;   // The types of the values on top of the stack.
+            llvm::Function* function;        // The specialized version of the word.
+        };
+
+
         // Information about a word that the compiler knows about.
         struct WordInfo
         {
@@ -361,6 +435,23 @@ namespace sorth::compilation
             WordInfoList words;
             WordMap word_map;
 
+            // The index of every word that's known to be one of the numeric operations.
+            std::unordered_map<size_t, NumericOp> numeric_words;
+
+            // How many values each Forth word takes from the top of the stack, as far as we can
+            // tell.  Filled in as the words are called.
+            std::unordered_map<size_t, size_t> input_counts;
+
+            // The words that have their index taken by the used code, these are the only words
+            // that a dynamic execute can end up calling.
+            std::set<size_t> indexed_words;
+
+            // The specialized versions of words that have been asked for by name, and the list of
+            // them in the order they were asked for.  Generating the code for a specialization can
+            // ask for more of them.
+            std::unordered_map<std::string, llvm::Function*> specialization_map;
+            std::vector<WordSpecialization> specializations;
+
             FfiTypeMap ffi_types;
 
             WordCollection(llvm::LLVMContext& context)
@@ -409,10 +500,9 @@ namespace sorth::compilation
                             {
                                 // Allocate a variable to hold the buffer reference.
                                 auto buffer_value = builder.CreateAlloca(runtime.value_struct_type);
-                                builder.CreateCall(runtime.initialize_variable, { buffer_value });
 
                                 // Try to pop a value from the data stack.
-                                auto pop_result = builder.CreateCall(runtime.stack_pop,
+                                auto pop_result = builder.CreateCall(runtime.stack_pop_move,
                                                                      { buffer_value });
 
                                 // Call the runtime function to get the pointer to the buffer's
@@ -1103,11 +1193,11 @@ namespace sorth::compilation
             auto uint64_ptr_type = llvm::PointerType::getUnqual(uint64_type);
             auto double_ptr_type = llvm::PointerType::getUnqual(double_type);
 
-            auto byte_type = llvm::Type::getInt8Ty(module->getContext());
-            auto byte_array_type = llvm::ArrayType::get(byte_type, value_size);
+            // Register the value struck type as an opaque data type.  We use 64-bit words for the
+            // storage so that the structure gets the same alignment as the native type.
+            auto word_array_type = llvm::ArrayType::get(uint64_type, value_size / sizeof(int64_t));
 
-            // Register the value struck type as an opaque data type.
-            std::vector<llvm::Type*> value_struct_members = { byte_array_type };
+            std::vector<llvm::Type*> value_struct_members = { word_array_type };
 
             auto value_struct_type = llvm::StructType::create(module->getContext(),
                                                               value_struct_members,
@@ -1117,6 +1207,25 @@ namespace sorth::compilation
 
             auto value_struct_ptr_array_type = llvm::ArrayType::get(value_struct_ptr_type, 0);
 
+            // Register the thread local data stack.  The generated code works with the base, top,
+            // and limit pointers directly.
+            auto data_stack_type = llvm::StructType::create(module->getContext(),
+                                                            {
+                                                                value_struct_ptr_type,
+                                                                value_struct_ptr_type,
+                                                                value_struct_ptr_type
+                                                            },
+                                                            "DataStack");
+
+            auto data_stack = new llvm::GlobalVariable(*module,
+                                                       data_stack_type,
+                                                       false,
+                                                       llvm::GlobalValue::ExternalLinkage,
+                                                       nullptr,
+                                                       "data_stack",
+                                                       nullptr,
+                                                       llvm::GlobalValue::InitialExecTLSModel);
+
             auto init_function_type = llvm::FunctionType::get(void_type, false);
             auto init_function_ptr_type = llvm::PointerType::getUnqual(init_function_type);
 
@@ -1170,17 +1279,64 @@ namespace sorth::compilation
                                                          llvm::Function::ExternalLinkage,
                                                          "write_variable",
                                                          module.get());
+            auto replace_variable = llvm::Function::Create(rw_variable_signature,
+                                                           llvm::Function::ExternalLinkage,
+                                                           "replace_variable",
+                                                           module.get());
 
             auto deep_copy_variable_signature = llvm::FunctionType::get(void_type,
                                                                   { value_struct_ptr_type,
                                                                     value_struct_ptr_type },
                                                                   false);
 
+            auto copy_variable = llvm::Function::Create(deep_copy_variable_signature,
+                                                        llvm::Function::ExternalLinkage,
+                                                        "copy_variable",
+                                                        module.get());
+
+            auto take_variable = llvm::Function::Create(deep_copy_variable_signature,
+                                                        llvm::Function::ExternalLinkage,
+                                                        "take_variable",
+                                                        module.get());
+
             auto deep_copy_variable = llvm::Function::Create(deep_copy_variable_signature,
                                                         llvm::Function::ExternalLinkage,
                                                         "deep_copy_variable",
                                                         module.get());
 
+            // Register the superinstruction functions.
+            auto variable_array_signature = llvm::FunctionType::get(bool_type,
+                                                                    {
+                                                                        value_struct_ptr_type,
+                                                                        uint64_type,
+                                                                        value_struct_ptr_type
+                                                                    },
+                                                                    false);
+            auto variable_array_read = llvm::Function::Create(variable_array_signature,
+                                                              llvm::Function::ExternalLinkage,
+                                                              "variable_array_read",
+                                                              module.get());
+            auto variable_array_write = llvm::Function::Create(variable_array_signature,
+                                                               llvm::Function::ExternalLinkage,
+                                                               "variable_array_write",
+                                                               module.get());
+
+            auto variable_hash_table_signature = llvm::FunctionType::get(bool_type,
+                                                                         {
+                                                                            value_struct_ptr_type,
+                                                                            value_struct_ptr_type,
+                                                                            value_struct_ptr_type
+                                                                         },
+                                                                         false);
+            auto variable_hash_table_read = llvm::Function::Create(variable_hash_table_signature,
+                                                                 llvm::Function::ExternalLinkage,
+                                                                 "variable_hash_table_read",
+                                                                 module.get());
+            auto variable_hash_table_write = llvm::Function::Create(variable_hash_table_signature,
+                                                                 llvm::Function::ExternalLinkage,
+                                                                 "variable_hash_table_write",
+                                                                 module.get());
+
             // Register the external stack functions.
             auto stack_push_signature = llvm::FunctionType::get(void_type,
                                                                 { value_struct_ptr_type },
@@ -1189,6 +1345,10 @@ namespace sorth::compilation
                                                      llvm::Function::ExternalLinkage,
                                                      "stack_push",
                                                      module.get());
+            auto stack_push_move = llvm::Function::Create(stack_push_signature,
+                                                          llvm::Function::ExternalLinkage,
+                                                          "stack_push_move",
+                                                          module.get());
 
             auto stack_push_int_signature = llvm::FunctionType::get(void_type,
                                                                     { uint64_type },
@@ -1229,6 +1389,10 @@ namespace sorth::compilation
                                                     llvm::Function::ExternalLinkage,
                                                     "stack_pop",
                                                     module.get());
+            auto stack_pop_move = llvm::Function::Create(stack_pop_signature,
+                                                         llvm::Function::ExternalLinkage,
+                                                         "stack_pop_move",
+                                                         module.get());
 
             auto stack_pop_int_signature = llvm::FunctionType::get(bool_type,
                                                                    { uint64_ptr_type },
@@ -1311,6 +1475,13 @@ namespace sorth::compilation
                                                            "clear_last_error",
                                                            module.get());
 
+            // Errors are rare, so the code that raises and handles them is kept out of the way of
+            // the main line of the program.
+            set_last_error->addFnAttr(llvm::Attribute::Cold);
+            get_last_error->addFnAttr(llvm::Attribute::Cold);
+            push_last_error->addFnAttr(llvm::Attribute::Cold);
+            clear_last_error->addFnAttr(llvm::Attribute::Cold);
+
             auto debug_print_signature = llvm::FunctionType::get(void_type,
                                                                  { char_ptr_type },
                                                                  false);
@@ -1374,6 +1545,11 @@ namespace sorth::compilation
                     .value_struct_ptr_type = value_struct_ptr_type,
                     .value_struct_ptr_array_type = value_struct_ptr_array_type,
 
+                    .value_layout = sorth::run_time::data_structures::Value::layout(),
+
+                    .data_stack_type = data_stack_type,
+                    .data_stack = data_stack,
+
                     .initialize_variable = initialize_variable,
                     .free_variable = free_variable,
                     .allocate_variable_block = allocate_variable_block,
@@ -1381,14 +1557,24 @@ namespace sorth::compilation
                     .get_byte_buffer_ptr = get_byte_buffer_ptr,
                     .read_variable = read_variable,
                     .write_variable = write_variable,
+                    .replace_variable = replace_variable,
+                    .copy_variable = copy_variable,
+                    .take_variable = take_variable,
                     .deep_copy_variable = deep_copy_variable,
 
+                    .variable_array_read = variable_array_read,
+                    .variable_array_write = variable_array_write,
+                    .variable_hash_table_read = variable_hash_table_read,
+                    .variable_hash_table_write = variable_hash_table_write,
+
                     .stack_push = stack_push,
+                    .stack_push_move = stack_push_move,
                     .stack_push_int = stack_push_int,
                     .stack_push_double = stack_push_double,
                     .stack_push_bool = stack_push_bool,
                     .stack_push_string = stack_push_string,
                     .stack_pop = stack_pop,
+                    .stack_pop_move = stack_pop_move,
                     .stack_pop_int = stack_pop_int,
                     .stack_pop_bool = stack_pop_bool,
                     .stack_pop_double = stack_pop_double,
@@ -1443,6 +1629,65 @@ namespace sorth::compilation
         }
 
 
+        // Find the words that perform numeric operations so that the code generator can perform
+        // them inline.  This needs to be called after the standard library has been gathered but
+        // before the script's words are, that way if the script redefines one of these words the
+        // new version is left alone.
+        void gather_numeric_words(WordCollection& collection)
+        {
+            // The run-time words, by their handler name.
+            static const std::unordered_map<std::string, NumericOp> runtime_ops =
+                {
+                    { "word_add",           NumericOp::add },
+                    { "word_subtract",      NumericOp::subtract },
+                    { "word_multiply",      NumericOp::multiply },
+                    { "word_divide",        NumericOp::divide },
+                    { "word_mod",           NumericOp::mod },
+                    { "word_equal",         NumericOp::equal },
+                    { "word_greater_equal", NumericOp::greater_equal },
+                    { "word_less_equal",    NumericOp::less_equal },
+                    { "word_greater",       NumericOp::greater },
+                    { "word_less",          NumericOp::less }
+                };
+
+            // The standard library extends these words to work with arrays and hash tables, but
+            // for numbers they do exactly what the run-time words do.
+            static const std::unordered_map<std::string, NumericOp> library_ops =
+                {
+                    { "+",  NumericOp::add },
+                    { "=",  NumericOp::equal },
+                    { "<>", NumericOp::not_equal }
+                };
+
+            for (size_t i = 0; i < collection.words.size(); ++i)
+            {
+                const auto& word = collection.words[i];
+
+                if (std::holds_alternative<NoExtraInfo>(word.extra_info))
+                {
+                    auto iterator = runtime_ops.find(word.handler_name);
+
+                    if (iterator != runtime_ops.end())
+                    {
+                        collection.numeric_words[i] = iterator->second;
+                    }
+                }
+            }
+
+            for (const auto& [ name, op ] : library_ops)
+            {
+                auto iterator = collection.word_map.find(name);
+
+                if (   (iterator != collection.word_map.end())
+                    && (std::holds_alternative<byte_code::ByteCode>(
+                                                collection.words[iterator->second].extra_info)))
+                {
+                    collection.numeric_words[iterator->second] = op;
+                }
+            }
+        }
+
+
         // Create the structure init and access words for the script and it's subscripts.
         void create_structure_words(const byte_code::ScriptPtr& script,
                                     WordCollection& collection)
@@ -2086,7 +2331,7 @@ namespace sorth::compilation
             auto next_block = generate_block();
             auto pop_result = builder.CreateCall(runtime.stack_pop, { structure_variable });
             auto cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
-            builder.CreateCondBr(cmp, error_block, next_block);
+            create_unlikely_branch(builder, cmp, error_block, next_block);
             builder.SetInsertPoint(next_block);
 
             // Now, is the value we popped a structure?
@@ -2096,7 +2341,7 @@ namespace sorth::compilation
             auto is_structure_result = builder.CreateCall(is_structure, { });
             next_block = generate_block();
             cmp = builder.CreateICmpNE(is_structure_result, builder.getInt1(0));
-            builder.CreateCondBr(cmp, error_block, next_block);
+            create_unlikely_branch(builder, cmp, error_block, next_block);
             builder.SetInsertPoint(next_block);
 
             // Check to see what if the structure check was successful...
@@ -2104,13 +2349,13 @@ namespace sorth::compilation
             pop_result = builder.CreateCall(runtime.stack_pop_bool, { is_structure_value });
             cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
             next_block = generate_block();
-            builder.CreateCondBr(cmp, error_block, next_block);
+            create_unlikely_branch(builder, cmp, error_block, next_block);
             builder.SetInsertPoint(next_block);
 
             auto loaded = builder.CreateLoad(bool_type, is_structure_value);
             cmp = builder.CreateICmpEQ(loaded, builder.getInt1(1));
             next_block = generate_block();
-            builder.CreateCondBr(cmp, next_block, error_block);
+            create_likely_branch(builder, cmp, next_block, error_block);
             builder.SetInsertPoint(next_block);
 
             // If we got here, it's a structure, now to see if it's the right structure?
@@ -2125,20 +2370,20 @@ namespace sorth::compilation
             auto is_type_result = builder.CreateCall(is_structure_of_type, { });
             next_block = generate_block();
             cmp = builder.CreateICmpNE(is_type_result, builder.getInt1(0));
-            builder.CreateCondBr(cmp, error_block, next_block);
+            create_unlikely_branch(builder, cmp, error_block, next_block);
             builder.SetInsertPoint(next_block);
 
             // Now we pop the result from the stack and check it.
             pop_result = builder.CreateCall(runtime.stack_pop_bool, { is_structure_value });
             cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
             next_block = generate_block();
-            builder.CreateCondBr(cmp, error_block, next_block);
+            create_unlikely_branch(builder, cmp, error_block, next_block);
             builder.SetInsertPoint(next_block);
 
             loaded = builder.CreateLoad(bool_type, is_structure_value);
             cmp = builder.CreateICmpEQ(loaded, builder.getInt1(1));
             next_block = generate_block();
-            builder.CreateCondBr(cmp, next_block, error_block);
+            create_likely_branch(builder, cmp, next_block, error_block);
             builder.SetInsertPoint(next_block);
 
             // Ok, it's a structure and it's our structure.  We can proceed to read the fields and
@@ -2154,7 +2399,7 @@ namespace sorth::compilation
                 auto read_result = builder.CreateCall(structure_read, { });
                 cmp = builder.CreateICmpNE(read_result, builder.getInt1(0));
                 next_block = generate_block();
-                builder.CreateCondBr(cmp, error_block, next_block);
+                create_unlikely_branch(builder, cmp, error_block, next_block);
                 builder.SetInsertPoint(next_block);
 
                 // Get a pointer to the field in the raw structure.
@@ -2167,7 +2412,7 @@ namespace sorth::compilation
                 auto pop_result = field_type.pop_value(builder, runtime, field_ref);
                 cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
                 next_block = generate_block();
-                builder.CreateCondBr(cmp, error_block, next_block);
+                create_unlikely_branch(builder, cmp, error_block, next_block);
                 builder.SetInsertPoint(next_block);
             }
 
@@ -2250,13 +2495,13 @@ namespace sorth::compilation
 
             auto create_result = builder.CreateCall(struct_new_word.function, { });
             auto cmp = builder.CreateICmpNE(create_result, builder.getInt1(0));
-            builder.CreateCondBr(cmp, exit_error_block, struct_pop_block);
+            create_unlikely_branch(builder, cmp, exit_error_block, struct_pop_block);
             builder.SetInsertPoint(struct_pop_block);
 
             // Pop the newly created structure from the stack.
             auto pop_result = builder.CreateCall(runtime.stack_pop, { struct_variable });
             cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
-            builder.CreateCondBr(cmp, exit_error_block, read_fields_block);
+            create_unlikely_branch(builder, cmp, exit_error_block, read_fields_block);
             builder.SetInsertPoint(read_fields_block);
 
             auto variable = function->getArg(0);
@@ -2287,9 +2532,10 @@ namespace sorth::compilation
                     // Otherwise we need to jump to the error block.
                     auto next_block = generate_block();
 
-                    builder.CreateCondBr(comparison_result,
-                                            exit_error_block,
-                                            next_block);
+                    create_unlikely_branch(builder,
+                                           comparison_result,
+                                           exit_error_block,
+                                           next_block);
 
                     // We are done with the current block, so move on to the next one.
                     builder.SetInsertPoint(next_block);
@@ -2306,7 +2552,7 @@ namespace sorth::compilation
 
                 // Check the result.
                 cmp = builder.CreateICmpNE(call_result, builder.getInt1(0));
-                builder.CreateCondBr(cmp, exit_error_block, field_blocks[i]);
+                create_unlikely_branch(builder, cmp, exit_error_block, field_blocks[i]);
                 builder.SetInsertPoint(field_blocks[i]);
             }
 
@@ -2423,7 +2669,7 @@ namespace sorth::compilation
 
                     // Make sure that the pop was successful.
                     auto cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
-                    builder.CreateCondBr(cmp, error_block, exit_block);
+                    create_unlikely_branch(builder, cmp, error_block, exit_block);
                 }
                 else
                 {
@@ -2439,7 +2685,7 @@ namespace sorth::compilation
                     // Check to see if the pop was successful.
                     auto cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
                     auto next_block = generate_block();
-                    builder.CreateCondBr(cmp, error_block, next_block);
+                    create_unlikely_branch(builder, cmp, error_block, next_block);
                     builder.SetInsertPoint(next_block);
 
                     // Memcpy the string into the variable, because it's a pointer to the raw
@@ -2494,20 +2740,20 @@ namespace sorth::compilation
             auto call_result = builder.CreateCall(is_array_fn, { });
             auto cmp = builder.CreateICmpNE(call_result, builder.getInt1(0));
             auto next_block = generate_block();
-            builder.CreateCondBr(cmp, error_block, next_block);
+            create_unlikely_branch(builder, cmp, error_block, next_block);
             builder.SetInsertPoint(next_block);
 
             auto is_array_value = builder.CreateAlloca(bool_type, nullptr, "is_array");
             pop_result = builder.CreateCall(runtime.stack_pop_bool, { is_array_value });
             cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
             next_block = generate_block();
-            builder.CreateCondBr(cmp, error_block, next_block);
+            create_unlikely_branch(builder, cmp, error_block, next_block);
             builder.SetInsertPoint(next_block);
 
             auto loaded_is_array = builder.CreateLoad(bool_type, is_array_value);
             cmp = builder.CreateICmpEQ(loaded_is_array, builder.getInt1(1));
             next_block = generate_block();
-            builder.CreateCondBr(cmp, next_block, error_block);
+            create_likely_branch(builder, cmp, next_block, error_block);
 
             // We have an array.
 
@@ -2530,7 +2776,7 @@ namespace sorth::compilation
             // Check to see if the pop was successful.
             cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
             next_block = generate_block();
-            builder.CreateCondBr(cmp, error_block, next_block);
+            create_unlikely_branch(builder, cmp, error_block, next_block);
             builder.SetInsertPoint(next_block);
 
             // Check to see if the array size is fixed, if it is, we need to make sure that the
@@ -2545,7 +2791,7 @@ namespace sorth::compilation
                 cmp = builder.CreateICmpEQ(loaded_array_size, array_size);
                 next_block = generate_block();
                 auto size_error_block = generate_block();
-                builder.CreateCondBr(cmp, next_block, size_error_block);
+                create_likely_branch(builder, cmp, next_block, size_error_block);
                 builder.SetInsertPoint(size_error_block);
 
                 // Report the error.
@@ -2611,7 +2857,7 @@ namespace sorth::compilation
             // Check for errors.
             cmp = builder.CreateICmpNE(read_error, builder.getInt1(0));
             next_block = generate_block();
-            builder.CreateCondBr(cmp, error_block, next_block);
+            create_unlikely_branch(builder, cmp, error_block, next_block);
 
             // Get the address of the element in the raw array.
             auto element_address = builder.CreateGEP(ffi_helper.type,
@@ -2627,7 +2873,7 @@ namespace sorth::compilation
             {
                 cmp = builder.CreateICmpNE(element_pop_result, builder.getInt1(0));
                 next_block = generate_block();
-                builder.CreateCondBr(cmp, error_block, next_block);
+                create_unlikely_branch(builder, cmp, error_block, next_block);
                 builder.SetInsertPoint(next_block);
             }
 
@@ -2750,7 +2996,7 @@ namespace sorth::compilation
             auto pop_result = builder.CreateCall(runtime.stack_pop, { dest_array_variable });
             auto cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
             auto next_block = generate_block();
-            builder.CreateCondBr(cmp, error_block, next_block);
+            create_unlikely_branch(builder, cmp, error_block, next_block);
             builder.SetInsertPoint(next_block);
 
             // Create a loop to extract each element from the array.  Create a loop index and
@@ -2784,7 +3030,7 @@ namespace sorth::compilation
             {
                 cmp = builder.CreateICmpNE(push_result, builder.getInt1(0));
                 next_block = generate_block();
-                builder.CreateCondBr(cmp, error_block, next_block);
+                create_unlikely_branch(builder, cmp, error_block, next_block);
                 builder.SetInsertPoint(next_block);
             }
 
@@ -2803,7 +3049,7 @@ namespace sorth::compilation
             // Check for errors.
             cmp = builder.CreateICmpNE(write_result, builder.getInt1(0));
             next_block = generate_block();
-            builder.CreateCondBr(cmp, error_block, next_block);
+            create_unlikely_branch(builder, cmp, error_block, next_block);
             builder.SetInsertPoint(next_block);
 
             // Increment the index.
@@ -3008,6 +3254,228 @@ namespace sorth::compilation
         }
 
 
+        // Can the Forth word's byte-code be copied into the words that call it?  It has to be small,
+        // and simple enough that it means the same thing wherever it's placed.
+        bool is_inlinable(const WordCollection& collection,
+                          size_t index,
+                          std::optional<size_t> caller_index)
+        {
+            using Id = byte_code::Instruction::Id;
+
+            // Past this size a call costs less than the extra code.
+            const size_t max_inline_size = 10;
+
+            const auto& word = collection.words[index];
+
+            // The numeric words are better off left for the code generator to handle inline.
+            if (   !std::holds_alternative<byte_code::ByteCode>(word.extra_info)
+                || (collection.numeric_words.find(index) != collection.numeric_words.end())
+                || (caller_index && (index == caller_index.value())))
+            {
+                return false;
+            }
+
+            const auto& code = std::get<byte_code::ByteCode>(word.extra_info);
+
+            if (code.size() > max_inline_size)
+            {
+                return false;
+            }
+
+            std::set<std::string> variables;
+
+            for (size_t i = 0; i < code.size(); ++i)
+            {
+                const auto& value = code[i].get_value();
+
+                switch (code[i].get_id())
+                {
+                    // Each call starts with fresh variables, but once inlined they keep their
+                    // values from one use to the next.  So they have to be given a value as soon
+                    // as they're defined.
+                    case Id::def_variable:
+                        if (   (i + 2 >= code.size())
+                            || (code[i + 1].get_id() != Id::execute)
+                            || (code[i + 1].get_value() != value)
+                            || (code[i + 2].get_id() != Id::write_variable))
+                        {
+                            return false;
+                        }
+
+                        variables.insert(value.get_string());
+                        break;
+
+                    // Any other name would be looked up amongst the caller's variables and
+                    // constants instead of our own.
+                    case Id::execute:
+                        if (value.is_string())
+                        {
+                            if (variables.find(value.get_string()) == variables.end())
+                            {
+                                return false;
+                            }
+                        }
+                        else if (   ((size_t)value.get_int() == index)
+                                 || (caller_index && ((size_t)value.get_int() == caller_index)))
+                        {
+                            return false;
+                        }
+                        break;
+
+                    case Id::def_constant:
+                    case Id::mark_loop_exit:
+                    case Id::unmark_loop_exit:
+                    case Id::jump_loop_start:
+                    case Id::jump_loop_exit:
+                    case Id::mark_catch:
+                    case Id::unmark_catch:
+                        return false;
+
+                    default:
+                        break;
+                }
+            }
+
+            return true;
+        }
+
+
+        // Replace calls to small Forth words with copies of the words' byte-code.  The variables
+        // of the inlined words are renamed so that they don't clash with the caller's, using names
+        // that can't be written in the source.  The caller_index is the word being optimized, if
+        // it's not the top-level code, so that mutually recursive words aren't inlined into each
+        // other.
+        size_t inline_small_words(const WordCollection& collection,
+                                  byte_code::ByteCode& code,
+                                  std::optional<size_t> caller_index,
+                                  size_t& inline_count)
+        {
+            using Id = byte_code::Instruction::Id;
+
+            std::unordered_map<size_t, byte_code::ByteCode> blocks;
+
+            for (size_t i = 0; i < code.size(); ++i)
+            {
+                const auto& value = code[i].get_value();
+
+                if (   (code[i].get_id() != Id::execute)
+                    || (!value.is_int())
+                    || (!is_inlinable(collection, value.get_int(), caller_index)))
+                {
+                    continue;
+                }
+
+                const auto& word = collection.words[value.get_int()];
+                auto block = std::get<byte_code::ByteCode>(word.extra_info);
+                auto prefix = "inline:" + std::to_string(inline_count) + " ";
+
+                for (auto& instruction : block)
+                {
+                    auto& instruction_value = instruction.get_value();
+
+                    if (   (   (instruction.get_id() == Id::def_variable)
+                            || (instruction.get_id() == Id::execute))
+                        && (instruction_value.is_string()))
+                    {
+                        instruction_value = prefix + instruction_value.get_string();
+                    }
+                }
+
+                blocks[i] = std::move(block);
+                ++inline_count;
+            }
+
+            if (!blocks.empty())
+            {
+                byte_code::splice_instructions(code, blocks);
+            }
+
+            return blocks.size();
+        }
+
+
+        // Run the byte-code optimization passes over all of the Forth words and the top-level code.
+        // This is done before we work out which words are used, because folding constants and
+        // removing dead code can remove calls.
+        void optimize_byte_code(WordCollection& collection,
+                                byte_code::ByteCode& top_level_code,
+                                bool print_statistics)
+        {
+            static const std::unordered_map<std::string, byte_code::StackOp> stack_ops =
+                {
+                    { "word_dup",  byte_code::StackOp::dup },
+                    { "word_drop", byte_code::StackOp::drop },
+                    { "word_swap", byte_code::StackOp::swap },
+                    { "word_over", byte_code::StackOp::over },
+                    { "word_rot",  byte_code::StackOp::rot },
+                    { "word_nip",  byte_code::StackOp::nip }
+                };
+
+            byte_code::KnownWords known_words;
+
+            known_words.numeric_words = collection.numeric_words;
+
+            for (size_t i = 0; i < collection.words.size(); ++i)
+            {
+                const auto& word = collection.words[i];
+
+                if (std::holds_alternative<NoExtraInfo>(word.extra_info))
+                {
+                    auto iterator = stack_ops.find(word.handler_name);
+
+                    if (iterator != stack_ops.end())
+                    {
+                        known_words.stack_words[i] = iterator->second;
+                    }
+                }
+            }
+
+            auto pass_manager = byte_code::create_standard_passes(known_words);
+
+            // Small words are inlined into their callers, so that the other passes get to work on
+            // them in place.  The word being optimized is worked out from the code we're given.
+            std::unordered_map<const byte_code::ByteCode*, size_t> word_indices;
+            size_t inline_count = 0;
+
+            for (size_t i = 0; i < collection.words.size(); ++i)
+            {
+                if (std::holds_alternative<byte_code::ByteCode>(collection.words[i].extra_info))
+                {
+                    word_indices[&std::get<byte_code::ByteCode>(collection.words[i].extra_info)] = i;
+                }
+            }
+
+            pass_manager.add_pass("inlining",
+                                  [&](byte_code::ByteCode& code)
+                                  {
+                                      auto iterator = word_indices.find(&code);
+                                      auto caller_index = iterator != word_indices.end()
+                                                          ? std::optional<size_t>(iterator->second)
+                                                          : std::nullopt;
+
+                                      return inline_small_words(collection,
+                                                                code,
+                                                                caller_index,
+                                                                inline_count);
+                                  });
+
+            for (auto& word : collection.words)
+            {
+                if (std::holds_alternative<byte_code::ByteCode>(word.extra_info))
+                {
+                    pass_manager.run(std::get<byte_code::ByteCode>(word.extra_info));
+                }
+            }
+
+            pass_manager.run(top_level_code);
+
+            if (print_statistics)
+            {
+                pass_manager.print_statistics(std::cerr);
+            }
+        }
+
+
         // Mark all the words that are used in the top-level code.  Also mark as used any words that
         // are called by the used words.
         void mark_used_words(WordCollection& collection, const byte_code::ByteCode& code)
@@ -3025,6 +3493,11 @@ namespace sorth::compilation
                         auto index = static_cast<size_t>(instruction.get_value().get_int());
                         auto& word = collection.words[index];
 
+                        if (instruction.get_id() == byte_code::Instruction::Id::word_index)
+                        {
+                            collection.indexed_words.insert(index);
+                        }
+
                         if (!word.was_referenced)
                         {
                             word.was_referenced = true;
@@ -3051,6 +3524,11 @@ namespace sorth::compilation
 
                             word_info.was_referenced = true;
 
+                            if (instruction.get_id() == byte_code::Instruction::Id::word_index)
+                            {
+                                collection.indexed_words.insert(index);
+                            }
+
                             if (std::holds_alternative<byte_code::ByteCode>(word_info.extra_info))
                             {
                                 mark_used_words(collection,
@@ -3179,1245 +3657,5098 @@ namespace sorth::compilation
 
 
 
-        // Generate the LLVM IR for a byte-code block.  This can be used for both Forth words and
-        // the top-level script code.
-        void generate_ir_for_byte_code(WordCollection& collection,
-                                       const std::string& word_name,
-                                       const byte_code::ByteCode& code,
-                                       std::shared_ptr<llvm::Module>& module,
-                                       llvm::LLVMContext& context,
-                                       llvm::IRBuilder<>& builder,
-                                       llvm::Function* function,
-                                       GlobalMap& global_constant_map,
-                                       const RuntimeApi& runtime_api,
-                                       bool is_top_level)
+        // Allocate a temporary in the function's entry block.  Temporaries allocated in the middle
+        // of the function would grow the native stack every time a loop body runs.
+        llvm::AllocaInst* create_entry_alloca(llvm::IRBuilder<>& builder, llvm::Type* type)
         {
-            // Gather some types we'll need.
-            auto bool_type = llvm::Type::getInt1Ty(context);
-            auto int64_type = llvm::Type::getInt64Ty(context);
-            auto double_type = llvm::Type::getDoubleTy(context);
-            auto char_type = llvm::Type::getInt1Ty(context);
-            auto char_ptr_type = llvm::PointerType::getUnqual(char_type);
+            auto& entry_block = builder.GetInsertBlock()->getParent()->getEntryBlock();
+            llvm::IRBuilder<> entry_builder(&entry_block, entry_block.begin());
 
-            // Keep track of the variables and constants that are used in the byte-code block.
-            ValueMap variable_map;
-            std::unordered_map<std::string, llvm::AllocaInst*> constant_map;
+            return entry_builder.CreateAlloca(type);
+        }
 
-            size_t block_index = 1;
 
-            // Keep track of the basic blocks we create for the jump targets.
-            auto blocks = std::unordered_map<size_t, llvm::BasicBlock*>();
-            auto auto_jump_blocks = std::unordered_map<size_t, std::pair<llvm::BasicBlock*,
-                                                                         llvm::BasicBlock*>>();
+        // Get a pointer to a byte offset within a value.
+        llvm::Value* value_field_ptr(llvm::IRBuilder<>& builder, llvm::Value* value, size_t offset)
+        {
+            return builder.CreateConstInBoundsGEP1_64(builder.getInt8Ty(), value, offset);
+        }
 
-            auto var_read_blocks = std::unordered_map<size_t, std::tuple<llvm::BasicBlock*,
-                                                                         llvm::BasicBlock*,
-                                                                         llvm::BasicBlock*>>();
 
-            // Create the entry block of the function.
-            auto entry_block = llvm::BasicBlock::Create(context, "entry_block", function);
-            builder.SetInsertPoint(entry_block);
+        // Write a scalar's tag and payload into a value.  The value must not be holding anything
+        // that needs to be freed.
+        void generate_store_scalar(llvm::IRBuilder<>& builder,
+                                   const RuntimeApi& runtime_api,
+                                   llvm::Value* value,
+                                   llvm::Value* payload,
+                                   uint8_t tag)
+        {
+            const auto& layout = runtime_api.value_layout;
 
-            // If this is the top-level code we need to register all of the script structure types
-            // with the run-time.
-            if (is_top_level)
-            {
-                for (const auto& structure : collection.structures)
-                {
-                    auto struct_name = define_string_constant(structure.get_name(),
-                                                              builder,
-                                                              module,
-                                                              context);
-                    auto field_count = structure.get_field_names().size();
-                    auto field_count_const = llvm::ConstantInt::get(int64_type, field_count);
+            auto stored_payload = payload->getType()->isIntegerTy(1)
+                                  ? builder.CreateZExt(payload, builder.getInt8Ty())
+                                  : payload;
 
-                    auto char_ptr_array_type = llvm::ArrayType::get(char_ptr_type, field_count);
+            builder.CreateStore(stored_payload, value_field_ptr(builder, value, layout.data_offset));
+            builder.CreateStore(builder.getInt8(tag),
+                                value_field_ptr(builder, value, layout.tag_offset));
+        }
 
-                    auto name_array_variable = builder.CreateAlloca(char_ptr_array_type);
 
-                    for (size_t i = 0; i < field_count; ++i)
-                    {
-                        auto field_name = define_string_constant(structure.get_field_names()[i],
-                                                                builder,
-                                                                module,
-                                                                context);
-                        auto array_ptr = builder.CreateStructGEP(char_ptr_array_type,
-                                                                 name_array_variable,
-                                                                 i);
-                        builder.CreateStore(field_name, array_ptr);
-                    }
+        // Generate the code to push a scalar value onto the data stack.  If there's room on the
+        // stack the tag and payload are written in place, otherwise we call into the run-time so
+        // that it can grow the stack.
+        void generate_push_scalar(llvm::IRBuilder<>& builder,
+                                  const RuntimeApi& runtime_api,
+                                  llvm::Value* payload,
+                                  uint8_t tag,
+                                  llvm::Function* slow_push)
+        {
+            auto& context = builder.getContext();
+            auto function = builder.GetInsertBlock()->getParent();
 
-                    auto iterator = collection.word_map.find(structure.get_name() +
-                                                             ".raw-init");
+            auto fast_block = llvm::BasicBlock::Create(context, "push_fast", function);
+            auto slow_block = llvm::BasicBlock::Create(context, "push_slow", function);
+            auto done_block = llvm::BasicBlock::Create(context, "push_done", function);
 
-                    if (iterator == collection.word_map.end())
-                    {
-                        throw std::runtime_error("Internal error, structure initializer not "
-                                                 "found.");
-                    }
+            auto top_ptr = builder.CreateStructGEP(runtime_api.data_stack_type,
+                                                   runtime_api.data_stack,
+                                                   1);
+            auto limit_ptr = builder.CreateStructGEP(runtime_api.data_stack_type,
+                                                     runtime_api.data_stack,
+                                                     2);
 
-                    auto init_handler = collection.words[iterator->second].function;
+            auto top = builder.CreateLoad(runtime_api.value_struct_ptr_type, top_ptr);
+            auto limit = builder.CreateLoad(runtime_api.value_struct_ptr_type, limit_ptr);
 
-                    builder.CreateCall(runtime_api.register_structure_type,
-                                       {
-                                           struct_name,
-                                           name_array_variable,
-                                           field_count_const,
-                                           init_handler
-                                       });
-                }
-            }
+            auto is_full = builder.CreateICmpEQ(top, limit);
+            create_unlikely_branch(builder, is_full, slow_block, fast_block);
 
-            // Keep track of any loop and catch block markers.
-            std::vector<std::pair<size_t, size_t>> loop_markers;
-            std::vector<size_t> catch_markers;
+            // There's room, so write the value directly into the next slot.
+            builder.SetInsertPoint(fast_block);
 
-            // Keep track of any jump targets that are the target of a catch block.
-            std::set<size_t> catch_target_markers;
+            generate_store_scalar(builder, runtime_api, top, payload, tag);
 
-            // Initialize the return value to false.
-            auto return_value_variable = builder.CreateAlloca(bool_type);
-            builder.CreateStore(builder.getInt1(0), return_value_variable);
+            auto new_top = builder.CreateConstInBoundsGEP1_64(runtime_api.value_struct_type,
+                                                              top,
+                                                              1);
+            builder.CreateStore(new_top, top_ptr);
+            builder.CreateBr(done_block);
 
-            // First pass...
-            //
-            // Gather the variables and constants that are used in the byte-code block.  We'll need
-            // to generate the value variables for the variables and constants.  As well as
-            // variables to hold the variable indicies at run-time.
-            //
-            // Also, we'll need go through the byte-code and for every instruction that can cause a
-            // branch we'll need to create basic blocks for each of the possible branches.
+            // The stack is full, let the run-time grow it.
+            builder.SetInsertPoint(slow_block);
+            builder.CreateCall(slow_push, { payload });
+            builder.CreateBr(done_block);
 
-            size_t var_index = 0;
+            builder.SetInsertPoint(done_block);
+        }
 
-            for (size_t i = 0; i < code.size(); ++i)
-            {
-                const auto& instruction = code[i];
 
-                switch (instruction.get_id())
-                {
-                    case byte_code::Instruction::Id::def_variable:
-                        {
-                            ValueInfo info;
+        // Generate the code to pop a scalar value from the data stack.  If the top of the stack
+        // holds a value of the expected type it is read directly, otherwise we fall back to the
+        // run-time function which handles conversions and reports errors.
+        //
+        // Returns the popped value and the error flag returned by the run-time function, (which is
+        // always false on the fast path.)
+        std::pair<llvm::Value*, llvm::Value*> generate_pop_scalar(llvm::IRBuilder<>& builder,
+                                                                  const RuntimeApi& runtime_api,
+                                                                  llvm::Type* type,
+                                                                  uint8_t tag,
+                                                                  llvm::Function* slow_pop)
+        {
+            auto& context = builder.getContext();
+            auto function = builder.GetInsertBlock()->getParent();
+            const auto& layout = runtime_api.value_layout;
+            bool is_bool = type->isIntegerTy(1);
 
-                            info.variable = builder.CreateAlloca(runtime_api.value_struct_type);
-                            info.variable_index = builder.CreateAlloca(int64_type);
-                            info.block_index = var_index;
+            auto check_block = llvm::BasicBlock::Create(context, "pop_check", function);
+            auto fast_block = llvm::BasicBlock::Create(context, "pop_fast", function);
+            auto slow_block = llvm::BasicBlock::Create(context, "pop_slow", function);
+            auto done_block = llvm::BasicBlock::Create(context, "pop_done", function);
 
-                            builder.CreateCall(runtime_api.initialize_variable,
-                                               { info.variable });
+            auto base_ptr = builder.CreateStructGEP(runtime_api.data_stack_type,
+                                                    runtime_api.data_stack,
+                                                    0);
+            auto top_ptr = builder.CreateStructGEP(runtime_api.data_stack_type,
+                                                   runtime_api.data_stack,
+                                                   1);
 
-                            ++var_index;
+            auto base = builder.CreateLoad(runtime_api.value_struct_ptr_type, base_ptr);
+            auto top = builder.CreateLoad(runtime_api.value_struct_ptr_type, top_ptr);
 
-                            variable_map[instruction.get_value().get_string()] = info;
-                        }
-                        break;
+            auto is_empty = builder.CreateICmpEQ(top, base);
+            create_unlikely_branch(builder, is_empty, slow_block, check_block);
 
-                    case byte_code::Instruction::Id::def_constant:
-                        if (is_top_level)
-                        {
-                            llvm::Constant* zero_init =
-                                    llvm::ConstantAggregateZero::get(runtime_api.value_struct_type);
+            // Make sure the value on top of the stack is of the type we're expecting.
+            builder.SetInsertPoint(check_block);
 
-                            auto constant = new llvm::GlobalVariable(*module,
-                                                                  runtime_api.value_struct_type,
-                                                                  false,
-                                                                  llvm::GlobalValue::PrivateLinkage,
-                                                                  zero_init);
+            auto last = builder.CreateConstInBoundsGEP1_64(runtime_api.value_struct_type, top, -1);
+            auto last_tag = builder.CreateLoad(builder.getInt8Ty(),
+                                               value_field_ptr(builder, last, layout.tag_offset));
 
-                            global_constant_map[instruction.get_value().get_string()] = constant;
-                            builder.CreateCall(runtime_api.initialize_variable, { constant });
-                        }
-                        else
-                        {
-                            auto const_variable =
-                                                builder.CreateAlloca(runtime_api.value_struct_type);
+            auto is_match = builder.CreateICmpEQ(last_tag, builder.getInt8(tag));
+            builder.CreateCondBr(is_match, fast_block, slow_block);
 
-                            constant_map[instruction.get_value().get_string()] = const_variable;
-                            builder.CreateCall(runtime_api.initialize_variable, { const_variable });
-                        }
-                        break;
+            // Read the payload directly.  Scalars have no destructor to run so we just need to
+            // move the top of the stack down.
+            builder.SetInsertPoint(fast_block);
 
-                    case byte_code::Instruction::Id::read_variable:
-                        {
-                            // Create the basic blocks for the instructions.
-                            std::stringstream stream;
+            llvm::Value* fast_value = nullptr;
 
-                            stream << "block_" << block_index;
-                            ++block_index;
+            if (is_bool)
+            {
+                auto raw_value = builder.CreateLoad(builder.getInt8Ty(),
+                                                    value_field_ptr(builder,
+                                                                    last,
+                                                                    layout.data_offset));
+                fast_value = builder.CreateICmpNE(raw_value, builder.getInt8(0));
+            }
+            else
+            {
+                fast_value = builder.CreateLoad(type,
+                                                value_field_ptr(builder, last, layout.data_offset));
+            }
 
-                            auto block_a = llvm::BasicBlock::Create(context,
-                                                                    stream.str(),
-                                                                    function);
+            builder.CreateStore(last, top_ptr);
+            builder.CreateBr(done_block);
 
-                            std::stringstream stream_b;
+            // Otherwise let the run-time deal with it.
+            builder.SetInsertPoint(slow_block);
 
-                            stream_b << "block_" << block_index;
-                            ++block_index;
+            auto slow_variable = create_entry_alloca(builder, type);
+            auto slow_result = builder.CreateCall(slow_pop, { slow_variable });
+            auto slow_value = builder.CreateLoad(type, slow_variable);
+            builder.CreateBr(done_block);
 
-                            auto block_b = llvm::BasicBlock::Create(context,
-                                                                    stream_b.str(),
-                                                                    function);
+            builder.SetInsertPoint(done_block);
 
-                            var_read_blocks[i] = { block_a, block_b, nullptr };
-                        }
-                        break;
+            auto value = builder.CreatePHI(type, 2);
+            value->addIncoming(fast_value, fast_block);
+            value->addIncoming(slow_value, slow_block);
 
-                    case byte_code::Instruction::Id::write_variable:
-                        {
-                            std::stringstream stream;
+            auto result = builder.CreatePHI(builder.getInt1Ty(), 2);
+            result->addIncoming(builder.getInt1(0), fast_block);
+            result->addIncoming(slow_result, slow_block);
 
-                            stream << "block_" << block_index;
-                            ++block_index;
+            return { value, result };
+        }
 
-                            auto block_a = llvm::BasicBlock::Create(context,
-                                                                    stream.str(),
-                                                                    function);
 
-                            std::stringstream stream_b;
+        // Pop a scalar value from the data stack that is already known to be there and to be of
+        // the given type.
+        llvm::Value* generate_pop_unchecked(llvm::IRBuilder<>& builder,
+                                            const RuntimeApi& runtime_api,
+                                            llvm::Type* type)
+        {
+            const auto& layout = runtime_api.value_layout;
 
-                            stream_b << "block_" << block_index;
-                            ++block_index;
+            auto top_ptr = builder.CreateStructGEP(runtime_api.data_stack_type,
+                                                   runtime_api.data_stack,
+                                                   1);
+            auto top = builder.CreateLoad(runtime_api.value_struct_ptr_type, top_ptr);
+            auto last = builder.CreateConstInBoundsGEP1_64(runtime_api.value_struct_type, top, -1);
 
-                            auto block_b = llvm::BasicBlock::Create(context,
-                                                                    stream_b.str(),
-                                                                    function);
+            llvm::Value* value = nullptr;
 
-                            std::stringstream stream_c;
+            if (type->isIntegerTy(1))
+            {
+                auto raw_value = builder.CreateLoad(builder.getInt8Ty(),
+                                                    value_field_ptr(builder,
+                                                                    last,
+                                                                    layout.data_offset));
+                value = builder.CreateICmpNE(raw_value, builder.getInt8(0));
+            }
+            else
+            {
+                value = builder.CreateLoad(type, value_field_ptr(builder, last, layout.data_offset));
+            }
 
-                            stream_c << "block_" << block_index;
-                            ++block_index;
+            builder.CreateStore(last, top_ptr);
 
-                            auto block_c = llvm::BasicBlock::Create(context,
-                                                                    stream_c.str(),
-                                                                    function);
+            return value;
+        }
 
-                            var_read_blocks[i] = { block_a, block_b, block_c };
-                        }
-                        break;
 
-                    case byte_code::Instruction::Id::execute:
-                    case byte_code::Instruction::Id::jump_loop_start:
-                    case byte_code::Instruction::Id::jump_loop_exit:
-                    case byte_code::Instruction::Id::jump_target:
-                        {
-                            // Create the basic blocks for the instructions.
-                            std::stringstream stream;
+        void generate_push_int(llvm::IRBuilder<>& builder,
+                               const RuntimeApi& runtime_api,
+                               llvm::Value* value)
+        {
+            generate_push_scalar(builder,
+                                 runtime_api,
+                                 value,
+                                 runtime_api.value_layout.int_tag,
+                                 runtime_api.stack_push_int);
+        }
 
-                            stream << "block_" << block_index;
-                            ++block_index;
 
-                            blocks[i] =
-                                    llvm::BasicBlock::Create(context,
-                                                             stream.str(),
-                                                             builder.GetInsertBlock()->getParent());
-                        }
-                        break;
+        void generate_push_double(llvm::IRBuilder<>& builder,
+                                  const RuntimeApi& runtime_api,
+                                  llvm::Value* value)
+        {
+            generate_push_scalar(builder,
+                                 runtime_api,
+                                 value,
+                                 runtime_api.value_layout.double_tag,
+                                 runtime_api.stack_push_double);
+        }
 
-                    case byte_code::Instruction::Id::jump_if_zero:
-                    case byte_code::Instruction::Id::jump_if_not_zero:
-                        {
-                            // These instructions have two jumps.  One jump for the pop error check
-                            // and one for the actual jump.  So we create two blocks for each of
-                            // these jump instructions.
-                            std::stringstream stream;
 
-                            stream << "block_" << block_index;
-                            ++block_index;
+        void generate_push_bool(llvm::IRBuilder<>& builder,
+                                const RuntimeApi& runtime_api,
+                                llvm::Value* value)
+        {
+            generate_push_scalar(builder,
+                                 runtime_api,
+                                 value,
+                                 runtime_api.value_layout.bool_tag,
+                                 runtime_api.stack_push_bool);
+        }
 
-                            auto block_a = llvm::BasicBlock::Create(context,
-                                                                    stream.str(),
-                                                                    function);
 
-                            std::stringstream stream_b;
+        std::pair<llvm::Value*, llvm::Value*> generate_pop_int(llvm::IRBuilder<>& builder,
+                                                               const RuntimeApi& runtime_api)
+        {
+            return generate_pop_scalar(builder,
+                                       runtime_api,
+                                       builder.getInt64Ty(),
+                                       runtime_api.value_layout.int_tag,
+                                       runtime_api.stack_pop_int);
+        }
 
-                            stream_b << "block_" << block_index;
-                            ++block_index;
 
-                            auto block_b = llvm::BasicBlock::Create(context,
-                                                                    stream_b.str(),
-                                                                    function);
+        std::pair<llvm::Value*, llvm::Value*> generate_pop_bool(llvm::IRBuilder<>& builder,
+                                                                const RuntimeApi& runtime_api)
+        {
+            return generate_pop_scalar(builder,
+                                       runtime_api,
+                                       builder.getInt1Ty(),
+                                       runtime_api.value_layout.bool_tag,
+                                       runtime_api.stack_pop_bool);
+        }
 
-                            auto_jump_blocks[i] = { block_a, block_b };
-                        }
-                        break;
 
-                    default:
-                        // Nothing to do here.
-                        break;
-                }
-            }
 
-            // Register the block of variables with the runtime.
-            if (!variable_map.empty())
-            {
-                auto value_array_type = llvm::ArrayType::get(runtime_api.value_struct_ptr_type,
-                                                             variable_map.size());
-                auto block_array = builder.CreateAlloca(value_array_type);
+        // While generating the code for a block of byte-code we simulate the data stack at compile
+        // time.  Values pushed by the byte-code are kept in SSA registers, (or in temporary value
+        // variables,) and are only written to the run-time data stack when something we can't see
+        // into needs them.  For example a call to another word or a jump to another block.
+        class VirtualStack
+        {
+            public:
+                using Kind = ValueKind;
 
-                for (const auto& [_, variable] : variable_map)
+                struct Entry
                 {
-                    auto array_ptr = builder.CreateStructGEP(value_array_type,
-                                                             block_array,
-                                                             variable.block_index);
-                    builder.CreateStore(variable.variable, array_ptr);
+                    Kind kind;
+                    llvm::Value* value;  // The register, the temporary, or the local variable.
+                    llvm::Value* index;  // For local variables, where its run-time index is kept.
+                };
+
+            private:
+                std::vector<Entry> entries;
+
+                // Set if a local variable's index was ever written to the run-time stack.  If so
+                // the word's variables need to be registered with the run-time so that the index
+                // can be resolved.
+                bool variable_escaped = false;
+
+                // Unboxed variables have no index, so if one of them would have had to be written
+                // to the run-time stack we remember it here.  The word then needs to be generated
+                // again with the variable boxed.
+                std::set<llvm::Value*> escaped_typed_variables;
+
+            public:
+                bool empty() const noexcept
+                {
+                    return entries.empty();
                 }
 
-                auto array_ptr = builder.CreateStructGEP(value_array_type, block_array, 0);
-                auto base_index = builder.CreateCall(runtime_api.allocate_variable_block,
-                                                     {
-                                                        array_ptr,
-                                                        builder.getInt64(variable_map.size())
-                                                     });
+                size_t size() const noexcept
+                {
+                    return entries.size();
+                }
 
-                for (const auto& [_, variable] : variable_map)
+                // Look at an entry counting down from the top of the stack.
+                const Entry& peek(size_t depth) const
                 {
-                    auto block_index = builder.getInt64(variable.block_index);
-                    auto new_index = builder.CreateAdd(base_index, block_index);
+                    return entries[entries.size() - 1 - depth];
+                }
 
-                    builder.CreateStore(new_index, variable.variable_index);
+                bool has_escaped_variables() const noexcept
+                {
+                    return variable_escaped;
                 }
-            }
 
-            // Create the block to handle errors.
-            auto exit_error_block = llvm::BasicBlock::Create(context, "error_block", function);
+                const std::set<llvm::Value*>& get_escaped_typed_variables() const noexcept
+                {
+                    return escaped_typed_variables;
+                }
 
-            // Create the end block of the function.
-            auto exit_block = llvm::BasicBlock::Create(context, "exit_block", function);
+                void push(Kind kind, llvm::Value* value)
+                {
+                    entries.push_back({ .kind = kind, .value = value, .index = nullptr });
+                }
 
-            // Register our block of variables with the runtime.
+                void push_variable(llvm::Value* variable, llvm::Value* index)
+                {
+                    entries.push_back({ .kind = Kind::variable, .value = variable, .index = index });
+                }
 
-            // Second pass...
-            //
-            // Now we can generate the LLVM IR for the byte-code block.
-            for (size_t i = 0; i < code.size(); ++i)
-            {
-                const auto& instruction = code[i];
+                // Is the top of the stack a known value of the given kind?
+                bool top_is(Kind kind) const noexcept
+                {
+                    return !entries.empty() && (entries.back().kind == kind);
+                }
 
-                switch (instruction.get_id())
+                // Is the top of the stack a known scalar value?
+                bool top_is_scalar() const noexcept
                 {
-                    case byte_code::Instruction::Id::def_variable:
-                        // Nothing to do here...  The variable has already been allocated and
-                        // initialized to a default state.
-                        break;
+                    return    !entries.empty()
+                           && (entries.back().kind != Kind::value)
+                           && (entries.back().kind != Kind::variable)
+                           && (entries.back().kind != Kind::typed_variable);
+                }
 
-                    case byte_code::Instruction::Id::def_constant:
-                        {
-                            auto name = instruction.get_value().get_string();
-                            auto iterator = constant_map.find(name);
+                // Can the top of the stack be duplicated without generating any code?
+                bool top_is_copyable() const noexcept
+                {
+                    return !entries.empty() && (entries.back().kind != Kind::value);
+                }
 
-                            llvm::Value* constant = nullptr;
+                // Get the kinds of the top count values, from the deepest up.  If any of them
+                // isn't a known scalar an empty list is returned.
+                std::vector<Kind> top_scalar_kinds(size_t count) const
+                {
+                    std::vector<Kind> kinds;
 
-                            if (iterator != constant_map.end())
-                            {
-                                constant = iterator->second;
-                            }
-                            else
-                            {
-                                constant = global_constant_map[name];
-                            }
+                    if ((count == 0) || (count > entries.size()))
+                    {
+                        return kinds;
+                    }
 
-                            // Pop the value for the new constant off of the stack.
-                            builder.CreateCall(runtime_api.stack_pop, { constant });
+                    for (auto iter = entries.end() - count; iter != entries.end(); ++iter)
+                    {
+                        if (   (iter->kind != Kind::int_value)
+                            && (iter->kind != Kind::double_value)
+                            && (iter->kind != Kind::bool_value))
+                        {
+                            return {};
                         }
-                        break;
 
-                    case byte_code::Instruction::Id::read_variable:
-                        {
-                            auto index_value = builder.CreateAlloca(int64_type);
-                            auto pop_result = builder.CreateCall(runtime_api.stack_pop_int,
-                                                                 { index_value });
+                        kinds.push_back(iter->kind);
+                    }
 
-                            auto [ next_block_a, next_block_b, _ ] = var_read_blocks[i];
+                    return kinds;
+                }
 
-                            // Jump to the catch block if there is one, or the exit block if not.
-                            auto error_block = catch_markers.empty()
-                                                ? exit_error_block
-                                                : blocks[catch_markers.back()];
+                Entry pop()
+                {
+                    auto entry = entries.back();
+                    entries.pop_back();
 
-                            auto cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
-                            builder.CreateCondBr(cmp, error_block, next_block_a);
+                    return entry;
+                }
 
-                            builder.SetInsertPoint(next_block_a);
+                // Write all of the known values onto the run-time stack, but keep tracking them.
+                // This is used on error paths where the stack needs to reflect the state of the
+                // program, while the regular path continues on with the values in registers.
+                void generate_materialize(llvm::IRBuilder<>& builder, const RuntimeApi& runtime_api)
+                {
+                    for (const auto& entry : entries)
+                    {
+                        generate_push_entry(builder, runtime_api, entry);
+                    }
+                }
 
-                            auto variable_temp = builder.CreateAlloca(runtime_api.value_struct_type);
-                            builder.CreateCall(runtime_api.initialize_variable, { variable_temp });
+                // Write a single entry onto the run-time stack.  Temporary values are moved onto
+                // the stack, leaving them empty.
+                void generate_push_entry(llvm::IRBuilder<>& builder,
+                                         const RuntimeApi& runtime_api,
+                                         const Entry& entry)
+                {
+                    switch (entry.kind)
+                    {
+                        case Kind::int_value:
+                            generate_push_int(builder, runtime_api, entry.value);
+                            break;
+
+                        case Kind::double_value:
+                            generate_push_double(builder, runtime_api, entry.value);
+                            break;
+
+                        case Kind::bool_value:
+                            generate_push_bool(builder, runtime_api, entry.value);
+                            break;
+
+                        case Kind::value:
+                            builder.CreateCall(runtime_api.stack_push_move, { entry.value });
+                            break;
+
+                        case Kind::variable:
+                            generate_push_int(builder,
+                                              runtime_api,
+                                              builder.CreateLoad(builder.getInt64Ty(),
+                                                                 entry.index));
+                            variable_escaped = true;
+                            break;
+
+                        case Kind::typed_variable:
+                            escaped_typed_variables.insert(entry.value);
+                            break;
+                    }
+                }
 
-                            auto index = builder.CreateLoad(int64_type, index_value);
-                            auto read_result = builder.CreateCall(runtime_api.read_variable,
-                                                                  { index, variable_temp });
+                // Write all of the known values onto the run-time stack and forget about them.
+                void generate_spill(llvm::IRBuilder<>& builder, const RuntimeApi& runtime_api)
+                {
+                    generate_materialize(builder, runtime_api);
+                    entries.clear();
+                }
 
-                            cmp = builder.CreateICmpNE(read_result, builder.getInt1(0));
-                            builder.CreateCondBr(cmp, error_block, next_block_b);
+                // Write all but the top count values onto the run-time stack and forget about
+                // them.  The values left in the virtual stack still logically sit above the ones
+                // written out.
+                void generate_spill_below(llvm::IRBuilder<>& builder,
+                                          const RuntimeApi& runtime_api,
+                                          size_t count)
+                {
+                    std::vector<Entry> top(entries.end() - count, entries.end());
 
-                            builder.SetInsertPoint(next_block_b);
+                    entries.erase(entries.end() - count, entries.end());
+                    generate_spill(builder, runtime_api);
 
-                            builder.CreateCall(runtime_api.stack_push, { variable_temp });
-                            builder.CreateCall(runtime_api.free_variable, { variable_temp });
+                    entries = std::move(top);
+                }
+
+                // If the handler is one of the run-time's native stack words and the values it
+                // works with are known, perform the word by shuffling the known values instead of
+                // calling it.  Returns false if the word needs to be called as normal.
+                bool generate_stack_word(llvm::IRBuilder<>& builder,
+                                         const RuntimeApi& runtime_api,
+                                         const std::string& handler_name)
+                {
+                    auto size = entries.size();
+
+                    // Release a value we own that's being dropped.
+                    auto drop_entry = [&](const Entry& entry)
+                        {
+                            if (entry.kind == Kind::value)
+                            {
+                                builder.CreateCall(runtime_api.free_variable, { entry.value });
+                            }
+                        };
+
+                    if (handler_name == "word_dup")
+                    {
+                        // We can't share a temporary value variable so only scalars and variable
+                        // references are duplicated in place.
+                        if (!top_is_copyable())
+                        {
+                            return false;
                         }
-                        break;
 
-                    case byte_code::Instruction::Id::write_variable:
+                        entries.push_back(entries.back());
+                    }
+                    else if (handler_name == "word_drop")
+                    {
+                        if (size < 1)
                         {
-                            auto index_value = builder.CreateAlloca(int64_type);
-                            auto pop_result = builder.CreateCall(runtime_api.stack_pop_int,
-                                                                 { index_value });
+                            return false;
+                        }
 
+                        drop_entry(pop());
+                    }
+                    else if (handler_name == "word_swap")
+                    {
+                        if (size < 2)
+                        {
+                            return false;
+                        }
 
-                            auto [ next_block_a, next_block_b, next_block_c ] = var_read_blocks[i];
+                        std::swap(entries[size - 1], entries[size - 2]);
+                    }
+                    else if (handler_name == "word_over")
+                    {
+                        // a b -- b a b
+                        if ((size < 2) || (!top_is_copyable()))
+                        {
+                            return false;
+                        }
 
-                            // Jump to the catch block if there is one, or the exit block if not.
-                            auto error_block = catch_markers.empty()
-                                                ? exit_error_block
-                                                : blocks[catch_markers.back()];
-                            auto cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
-                            builder.CreateCondBr(cmp, error_block, next_block_a);
+                        std::swap(entries[size - 1], entries[size - 2]);
+                        entries.push_back(entries[size - 2]);
+                    }
+                    else if (handler_name == "word_rot")
+                    {
+                        // a b c -- c a b
+                        if (size < 3)
+                        {
+                            return false;
+                        }
 
-                            builder.SetInsertPoint(next_block_a);
+                        std::rotate(entries.end() - 3, entries.end() - 1, entries.end());
+                    }
+                    else if (handler_name == "word_nip")
+                    {
+                        if (size < 2)
+                        {
+                            return false;
+                        }
 
-                            auto variable_temp =
-                                                builder.CreateAlloca(runtime_api.value_struct_type);
-                            builder.CreateCall(runtime_api.initialize_variable, { variable_temp });
+                        drop_entry(entries[size - 2]);
+                        entries.erase(entries.end() - 2);
+                    }
+                    else
+                    {
+                        return false;
+                    }
 
-                            pop_result = builder.CreateCall(runtime_api.stack_pop,
-                                                            { variable_temp });
+                    return true;
+                }
+        };
 
-                            cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
-                            builder.CreateCondBr(cmp, error_block, next_block_b);
 
-                            builder.SetInsertPoint(next_block_b);
+        // Convert a scalar entry from the virtual stack to an i1 test value.  Ints and floats are
+        // true if they are non-zero, just as in Value::get_bool.
+        llvm::Value* generate_entry_to_bool(llvm::IRBuilder<>& builder,
+                                            const VirtualStack::Entry& entry)
+        {
+            switch (entry.kind)
+            {
+                case VirtualStack::Kind::int_value:
+                    return builder.CreateICmpNE(entry.value, builder.getInt64(0));
 
-                            auto index = builder.CreateLoad(int64_type, index_value);
-                            auto write_result = builder.CreateCall(runtime_api.write_variable,
-                                                                   { index, variable_temp });
-                            builder.CreateCall(runtime_api.free_variable, { variable_temp });
+                case VirtualStack::Kind::double_value:
+                    return builder.CreateFCmpUNE(entry.value,
+                                                 llvm::ConstantFP::get(builder.getDoubleTy(), 0.0));
 
-                            cmp = builder.CreateICmpNE(write_result, builder.getInt1(0));
-                            builder.CreateCondBr(cmp, error_block, next_block_c);
+                default:
+                    break;
+            }
 
-                            builder.SetInsertPoint(next_block_c);
-                        }
-                        break;
+            return entry.value;
+        }
 
-                    case byte_code::Instruction::Id::execute:
-                        {
-                            auto& value = instruction.get_value();
 
-                            if (value.is_string())
-                            {
-                                auto name = value.get_string();
+        // Get the LLVM type used to hold a scalar kind of value.
+        llvm::Type* get_scalar_type(llvm::IRBuilder<>& builder, VirtualStack::Kind kind)
+        {
+            switch (kind)
+            {
+                case VirtualStack::Kind::double_value:
+                    return builder.getDoubleTy();
 
-                                auto var_iter = variable_map.find(name);
-                                auto const_iter = constant_map.find(name);
-                                auto global_iter = global_constant_map.find(name);
+                case VirtualStack::Kind::bool_value:
+                    return builder.getInt1Ty();
 
-                                if (var_iter != variable_map.end())
-                                {
-                                    auto variable_index =
-                                                builder.CreateLoad(int64_type,
-                                                                   var_iter->second.variable_index);
-                                    builder.CreateCall(runtime_api.stack_push_int,
-                                                       { variable_index });
-                                }
-                                else if (const_iter != constant_map.end())
-                                {
-                                    auto variable_temp =
-                                                builder.CreateAlloca(runtime_api.value_struct_type);
-                                    builder.CreateCall(runtime_api.initialize_variable,
-                                                       { variable_temp });
+                default:
+                    break;
+            }
 
-                                    builder.CreateCall(runtime_api.deep_copy_variable,
-                                                       { const_iter->second, variable_temp });
+            return builder.getInt64Ty();
+        }
 
-                                    builder.CreateCall(runtime_api.stack_push,
-                                                       { variable_temp });
 
-                                    builder.CreateCall(runtime_api.free_variable,
-                                                       { variable_temp });
-                                }
-                                else if (global_iter != global_constant_map.end())
-                                {
-                                    auto variable_temp =
-                                                builder.CreateAlloca(runtime_api.value_struct_type);
-                                    builder.CreateCall(runtime_api.initialize_variable,
-                                                       { variable_temp });
+        // Write a scalar entry from the virtual stack into a freshly initialized value variable.
+        void generate_entry_to_value(llvm::IRBuilder<>& builder,
+                                     const RuntimeApi& runtime_api,
+                                     const VirtualStack::Entry& entry,
+                                     llvm::Value* variable)
+        {
+            const auto& layout = runtime_api.value_layout;
 
-                                    builder.CreateCall(runtime_api.deep_copy_variable,
-                                                       { global_iter->second, variable_temp });
+            uint8_t tag = entry.kind == VirtualStack::Kind::int_value    ? layout.int_tag
+                        : entry.kind == VirtualStack::Kind::double_value ? layout.double_tag
+                                                                         : layout.bool_tag;
 
-                                    builder.CreateCall(runtime_api.stack_push,
-                                                       { variable_temp });
+            generate_store_scalar(builder, runtime_api, variable, entry.value, tag);
+        }
 
-                                    builder.CreateCall(runtime_api.free_variable,
-                                                       { variable_temp });
-                                }
-                                else
-                                {
-                                    throw_error("Word " + name + " not found for execution, " +
-                                                "referenced by " + word_name + ".");
-                                }
 
-                                builder.CreateBr(blocks[i]);
-                                builder.SetInsertPoint(blocks[i]);
-                            }
-                            else if (value.is_numeric())
-                            {
-                                auto index = value.get_int();
+        // Load the type tag of a value.
+        llvm::Value* generate_load_tag(llvm::IRBuilder<>& builder,
+                                       const RuntimeApi& runtime_api,
+                                       llvm::Value* value)
+        {
+            return builder.CreateLoad(builder.getInt8Ty(),
+                                      value_field_ptr(builder,
+                                                      value,
+                                                      runtime_api.value_layout.tag_offset));
+        }
 
-                                if (   (index < 0)
-                                    || (index >= collection.words.size()))
-                                {
-                                    throw_error("Word index " + std::to_string(index) +
-                                                " out of range.");
-                                }
 
-                                auto handler = collection.words[index].function;
-                                auto result = builder.CreateCall(handler, {});
+        // Check if a type tag is for one of the types that don't own any memory.
+        llvm::Value* generate_tag_is_scalar(llvm::IRBuilder<>& builder,
+                                            const RuntimeApi& runtime_api,
+                                            llvm::Value* tag)
+        {
+            auto mask = builder.getInt64(runtime_api.value_layout.scalar_tag_mask);
+            auto bit = builder.CreateLShr(mask, builder.CreateZExt(tag, builder.getInt64Ty()));
 
-                                // Check the result of the call instruction and branch to the next
-                                // if no errors were raised, otherwise branch to the either the
-                                // exit block or the exception handler block.
-                                auto next_block = blocks[i];
+            return builder.CreateTrunc(bit, builder.getInt1Ty());
+        }
 
-                                // Jump to the catch block if there is one, or the exit block if
-                                // not.
-                                auto error_block = catch_markers.empty()
-                                                    ? exit_error_block
-                                                    : blocks[catch_markers.back()];
-                                auto cmp = builder.CreateICmpNE(result, builder.getInt1(0));
-                                builder.CreateCondBr(cmp, error_block, next_block);
 
-                                // We're done with the current block, so move on to the next one.
-                                builder.SetInsertPoint(next_block);
-                            }
-                        }
-                        break;
+        // Copy one value variable to another.  If neither of them hold anything that owns memory
+        // the tag and payload are copied directly, otherwise we let the run-time do the copy.  If
+        // requested the input is consumed, it's moved into the output instead of being copied.
+        void generate_copy_value(llvm::IRBuilder<>& builder,
+                                 const RuntimeApi& runtime_api,
+                                 llvm::Value* input,
+                                 llvm::Value* output,
+                                 bool free_input)
+        {
+            auto& context = builder.getContext();
+            auto function = builder.GetInsertBlock()->getParent();
+            const auto& layout = runtime_api.value_layout;
+
+            auto fast_block = llvm::BasicBlock::Create(context, "copy_fast", function);
+            auto slow_block = llvm::BasicBlock::Create(context, "copy_slow", function);
+            auto done_block = llvm::BasicBlock::Create(context, "copy_done", function);
+
+            auto input_tag = generate_load_tag(builder, runtime_api, input);
+            auto output_tag = generate_load_tag(builder, runtime_api, output);
+
+            auto both_scalar = builder.CreateAnd(generate_tag_is_scalar(builder,
+                                                                        runtime_api,
+                                                                        input_tag),
+                                                 generate_tag_is_scalar(builder,
+                                                                        runtime_api,
+                                                                        output_tag));
+            builder.CreateCondBr(both_scalar, fast_block, slow_block);
+
+            builder.SetInsertPoint(fast_block);
+            builder.CreateMemCpy(value_field_ptr(builder, output, layout.data_offset),
+                                 llvm::MaybeAlign(1),
+                                 value_field_ptr(builder, input, layout.data_offset),
+                                 llvm::MaybeAlign(1),
+                                 sizeof(int64_t));
+            builder.CreateStore(input_tag, value_field_ptr(builder, output, layout.tag_offset));
+            builder.CreateBr(done_block);
+
+            builder.SetInsertPoint(slow_block);
+
+            if (free_input)
+            {
+                builder.CreateCall(runtime_api.take_variable, { input, output });
+            }
+            else
+            {
+                builder.CreateCall(runtime_api.copy_variable, { input, output });
+            }
 
-                    case byte_code::Instruction::Id::word_index:
-                        {
-                            auto word_name = instruction.get_value().get_string();
-                            auto exists = collection.word_map.find(word_name);
+            builder.CreateBr(done_block);
 
-                            if (exists == collection.word_map.end())
-                            {
-                                throw_error("Word " + word_name + " not found for indexing.");
-                            }
+            builder.SetInsertPoint(done_block);
+        }
 
-                            auto word_info = collection.words[exists->second];
 
-                            auto index = exists->second;
-                            auto index_const = builder.getInt64(index);
+        bool is_comparison(NumericOp op) noexcept
+        {
+            return op >= NumericOp::equal;
+        }
 
-                            builder.CreateCall(runtime_api.stack_push_int, { index_const });
-                        }
-                        break;
 
-                    case byte_code::Instruction::Id::word_exists:
-                        {
-                            auto exists = collection.word_map
-                                                    .find(instruction.get_value().get_string())
-                                                    != collection.word_map.end();
+        // Check that an integer division won't fault.  Division by zero and the one division that
+        // overflows are left to the run-time.
+        llvm::Value* generate_division_is_safe(llvm::IRBuilder<>& builder,
+                                               llvm::Value* a,
+                                               llvm::Value* b)
+        {
+            auto is_zero = builder.CreateICmpEQ(b, builder.getInt64(0));
+            auto is_overflow = builder.CreateAnd(builder.CreateICmpEQ(a,
+                                                                      builder.getInt64(INT64_MIN)),
+                                                 builder.CreateICmpEQ(b, builder.getInt64(-1)));
 
-                            auto exists_const = llvm::ConstantInt::get(bool_type, exists);
-                            builder.CreateCall(runtime_api.stack_push_bool, { exists_const });
-                        }
-                        break;
+            return builder.CreateNot(builder.CreateOr(is_zero, is_overflow));
+        }
 
-                    case byte_code::Instruction::Id::push_constant_value:
-                        {
-                            // Get the value to push from the instruction.
-                            auto& value = code[i].get_value();
 
-                            // Check the type of the value.  If it's one of the simple types
-                            // directly generate the code to push it's value onto the stack.
-                            if (value.is_bool())
-                            {
-                                auto bool_value = value.get_bool();
-                                auto bool_const = llvm::ConstantInt::get(bool_type, bool_value);
-                                builder.CreateCall(runtime_api.stack_push_bool,
-                                                    { bool_const });
-                            }
-                            else if (value.is_int())
-                            {
-                                auto int_value = value.get_int();
-                                auto int_const = llvm::ConstantInt::get(int64_type, int_value);
-                                builder.CreateCall(runtime_api.stack_push_int,
-                                                    { int_const });
-                            }
-                            else if (value.is_double())
-                            {
-                                auto double_value = value.get_double();
-                                auto double_const = llvm::ConstantFP::get(double_type,
-                                                                            double_value);
-                                builder.CreateCall(runtime_api.stack_push_double,
-                                                    { double_const });
-                            }
-                            else if (value.is_string())
-                            {
-                                auto string_value = value.get_string();
-                                auto string_ptr = define_string_constant(string_value,
-                                                                            builder,
-                                                                            module,
-                                                                            context);
-                                builder.CreateCall(runtime_api.stack_push_string,
-                                                    { string_ptr });
-                            }
-                            else
-                            {
-                                throw_error("TODO: Implement complex constant types.");
-                            }
-                        }
-                        break;
+        // Generate a numeric operation on two int64_t values.
+        llvm::Value* generate_int_op(llvm::IRBuilder<>& builder,
+                                     NumericOp op,
+                                     llvm::Value* a,
+                                     llvm::Value* b)
+        {
+            switch (op)
+            {
+                case NumericOp::add:           return builder.CreateAdd(a, b);
+                case NumericOp::subtract:      return builder.CreateSub(a, b);
+                case NumericOp::multiply:      return builder.CreateMul(a, b);
+                case NumericOp::divide:        return builder.CreateSDiv(a, b);
+                case NumericOp::mod:           return builder.CreateSRem(a, b);
+                case NumericOp::equal:         return builder.CreateICmpEQ(a, b);
+                case NumericOp::not_equal:     return builder.CreateICmpNE(a, b);
+                case NumericOp::greater_equal: return builder.CreateICmpSGE(a, b);
+                case NumericOp::less_equal:    return builder.CreateICmpSLE(a, b);
+                case NumericOp::greater:       return builder.CreateICmpSGT(a, b);
+                case NumericOp::less:          return builder.CreateICmpSLT(a, b);
+            }
 
-                    case byte_code::Instruction::Id::mark_loop_exit:
-                        {
-                            // Capture the start and end indexes of the loop for later use.
-                            auto start_index = i + 1;
-                            auto end_index = i + code[i].get_value().get_int();
+            throw std::runtime_error("Internal error, unknown numeric operation.");
+        }
 
-                            loop_markers.push_back({ start_index, end_index });
-                        }
-                        break;
 
-                    case byte_code::Instruction::Id::unmark_loop_exit:
-                        {
-                            // Clear the current loop markers.
-                            loop_markers.pop_back();
-                        }
-                        break;
+        // Generate a numeric operation on two double values.  The run-time only performs mod on
+        // integers, so it isn't handled here.
+        llvm::Value* generate_double_op(llvm::IRBuilder<>& builder,
+                                        NumericOp op,
+                                        llvm::Value* a,
+                                        llvm::Value* b)
+        {
+            switch (op)
+            {
+                case NumericOp::add:           return builder.CreateFAdd(a, b);
+                case NumericOp::subtract:      return builder.CreateFSub(a, b);
+                case NumericOp::multiply:      return builder.CreateFMul(a, b);
+                case NumericOp::divide:        return builder.CreateFDiv(a, b);
+                case NumericOp::equal:         return builder.CreateFCmpOEQ(a, b);
+                case NumericOp::not_equal:     return builder.CreateFCmpUNE(a, b);
+                case NumericOp::greater_equal: return builder.CreateFCmpOGE(a, b);
+                case NumericOp::less_equal:    return builder.CreateFCmpOLE(a, b);
+                case NumericOp::greater:       return builder.CreateFCmpOGT(a, b);
+                case NumericOp::less:          return builder.CreateFCmpOLT(a, b);
+
+                case NumericOp::mod:
+                    break;
+            }
 
-                    case byte_code::Instruction::Id::mark_catch:
-                        {
-                            // Capture the index of the catch block for later use.
-                            auto target_index = i + code[i].get_value().get_int();
+            throw std::runtime_error("Internal error, unsupported floating point operation.");
+        }
 
-                            catch_markers.push_back(target_index);
-                            catch_target_markers.insert(target_index);
-                        }
-                        break;
 
-                    case byte_code::Instruction::Id::unmark_catch:
-                        {
-                            // Clear the current catch markers so that we don't jump to then.
-                            // Note that we leave the catch_target_markers set alone so that we
-                            // can generate the code to push the exception onto the stack when
-                            // we reach the catch target instruction.
-                            catch_markers.pop_back();
-                        }
-                        break;
 
-                    case byte_code::Instruction::Id::mark_context:
-                        // TODO: Implement this.
-                        break;
+        // What the type inference pass found out about a word's local variables.  Variables that
+        // are only ever given values of one scalar type are kept unboxed.
+        struct WordTypes
+        {
+            // A parameter popped straight off of the stack into a typed variable as the word
+            // starts.
+            struct Parameter
+            {
+                size_t depth;        // How deep in the stack the parameter is when the word starts.
+                size_t write_index;  // The write_variable instruction that pops it.
+            };
 
-                    case byte_code::Instruction::Id::release_context:
-                        // TODO: Implement this.
-                        break;
+            // The unboxed type of each of the variables that could be typed.
+            std::unordered_map<std::string, VirtualStack::Kind> variables;
 
-                    case byte_code::Instruction::Id::jump:
-                        {
-                            // Jump to the target block.
-                            auto index = i + code[i].get_value().get_int();
-                            builder.CreateBr(blocks[index]);
-                        }
-                        break;
+            // The parameters that are written to typed variables.  Their types are checked when
+            // the word is called, and if they don't match the generic version of the word is run
+            // instead.
+            std::unordered_map<std::string, Parameter> parameters;
 
-                    case byte_code::Instruction::Id::jump_if_zero:
-                        {
-                            // Convert the relative index to an absolute index.
-                            auto index = i + code[i].get_value().get_int();
+            // For specialized versions of the word, the types of the values that are taken off of
+            // the stack as the word starts.  The caller has guaranteed their types.
+            std::vector<VirtualStack::Kind> inputs;
 
-                            // Allocate a bool to hold the test value.  Then call the
-                            // handle_pop_bool function to get the value from the stack.
-                            auto test_value = builder.CreateAlloca(bool_type);
-                            auto pop_result = builder.CreateCall(runtime_api.stack_pop_bool,
-                                                                { test_value });
+            // The generic version of the word, if one is needed.
+            llvm::Function* generic_function = nullptr;
 
-                            // Check the result of the call instruction and branch to the next
-                            // block if no errors were raised, otherwise branch to the either
-                            // the exit block or the exception handler block.
-                            auto error_block = catch_markers.empty()
-                                                ? exit_error_block
-                                                : blocks[catch_markers.back()];
+            // Forget about a variable's type, it will be kept boxed.
+            void make_boxed(const std::string& name)
+            {
+                variables.erase(name);
+                parameters.erase(name);
+            }
+        };
 
-                            auto [ a, b ] = auto_jump_blocks[i];
 
-                            auto cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
-                            builder.CreateCondBr(cmp, error_block, a);
+        // Infer the types of a word's local variables by running through the word's byte-code
+        // while keeping track of the types of the values on the stack.  This follows what the code
+        // generator's virtual stack will do, values are known within a block, and anything written
+        // to the run-time stack is of unknown type.
+        //
+        // We only bother for words that loop, that's where keeping the variables unboxed pays off,
+        // unless we're generating a specialized version of the word.  Then the types of the values
+        // the word starts with are known from the inputs.
+        WordTypes infer_word_types(const WordCollection& collection,
+                                   const byte_code::ByteCode& code,
+                                   const std::vector<VirtualStack::Kind>& inputs = {})
+        {
+            using Id = byte_code::Instruction::Id;
 
-                            // The pop was successful, so switch to the next block and generate
-                            // the code to perform the jump based on the test value.
-                            builder.SetInsertPoint(a);
+            WordTypes word_types;
 
-                            // Jump to the 'success' block if the test value is true, otherwise
-                            // jump to the 'fail' block.
-                            auto read_value = builder.CreateLoad(bool_type, test_value);
+            word_types.inputs = inputs;
 
-                            builder.CreateCondBr(read_value, b, blocks[index]);
-                            builder.SetInsertPoint(b);
+            auto has_loop = std::any_of(code.begin(),
+                                        code.end(),
+                                        [](const auto& instruction)
+                                        {
+                                            auto id = instruction.get_id();
+
+                                            return    (id == Id::jump_loop_start)
+                                                   || (   (   (id == Id::jump)
+                                                           || (id == Id::jump_if_zero)
+                                                           || (id == Id::jump_if_not_zero))
+                                                       && (instruction.get_value().get_int() < 0));
+                                        });
+
+            if (!has_loop && inputs.empty())
+            {
+                return word_types;
+            }
+
+            // The type of a value, pending is for variables that haven't been given a value yet,
+            // and any is for values that could be anything.
+            enum class Type
+            {
+                pending,
+                int_value,
+                double_value,
+                bool_value,
+                any,
+                variable
+            };
+
+            struct Item
+            {
+                Type type;
+                std::string variable;       // The name of the variable, if this is a reference.
+                const run_time::Value* constant;  // The value if it's a constant.
+            };
+
+            auto join = [](Type a, Type b)
+                {
+                    if (a == Type::pending) return b;
+                    if (b == Type::pending) return a;
+
+                    return a == b ? a : Type::any;
+                };
+
+            // Find all of the word's variables.  Unless it's given a value as soon as it's defined a
+            // variable starts out as none, so it can't be typed.
+            std::unordered_map<std::string, Type> variables;
+
+            for (size_t i = 0; i < code.size(); ++i)
+            {
+                if (code[i].get_id() == Id::def_variable)
+                {
+                    const auto& name = code[i].get_value().get_string();
+
+                    bool is_initialized =    (i + 2 < code.size())
+                                          && (code[i + 1].get_id() == Id::execute)
+                                          && (code[i + 1].get_value().is_string())
+                                          && (code[i + 1].get_value().get_string() == name)
+                                          && (code[i + 2].get_id() == Id::write_variable);
+
+                    variables[name] = is_initialized ? Type::pending : Type::any;
+                }
+            }
+
+            // Run through the code until the variable types stop changing.
+            bool changed = true;
+
+            while (changed)
+            {
+                changed = false;
+
+                std::vector<Item> stack;
+                bool in_prologue = true;
+
+                for (auto input : inputs)
+                {
+                    auto type = input == VirtualStack::Kind::double_value ? Type::double_value
+                              : input == VirtualStack::Kind::bool_value   ? Type::bool_value
+                                                                          : Type::int_value;
+
+                    stack.push_back({ .type = type, .variable = "", .constant = nullptr });
+                }
+                size_t parameter_depth = 0;
+
+                auto update = [&](const std::string& name, Type type)
+                    {
+                        auto& current = variables[name];
+                        auto joined = join(current, type);
+
+                        if (joined != current)
+                        {
+                            current = joined;
+                            changed = true;
                         }
-                        break;
+                    };
 
-                    case byte_code::Instruction::Id::jump_if_not_zero:
+                // Everything is written to the run-time stack, including any variable references,
+                // so those variables can no longer be tracked.
+                auto spill = [&]()
+                    {
+                        for (const auto& item : stack)
                         {
-                            // Convert the relative index to an absolute index.
-                            auto index = i + code[i].get_value().get_int();
+                            if (item.type == Type::variable)
+                            {
+                                update(item.variable, Type::any);
+                            }
+                        }
 
-                            // Allocate a bool to hold the test value.  Then call the
-                            // handle_pop_bool function to get the value from the stack.
-                            auto test_value = builder.CreateAlloca(bool_type);
-                            auto pop_result = builder.CreateCall(runtime_api.stack_pop_bool,
-                                                                { test_value });
+                        stack.clear();
+                    };
 
-                            // Check the result of the call instruction and branch to the next
-                            // block if no errors were raised, otherwise branch to the either
-                            // the exit block or the exception handler block.
-                            auto error_block = catch_markers.empty()
-                                                ? exit_error_block
-                                                : blocks[catch_markers.back()];
+                auto push = [&](Type type, const run_time::Value* constant = nullptr)
+                    {
+                        stack.push_back({ .type = type, .variable = "", .constant = constant });
+                    };
 
-                            auto [ a, b ] = auto_jump_blocks[i];
+                auto top_is = [&](Type type)
+                    {
+                        return !stack.empty() && (stack.back().type == type);
+                    };
 
-                            auto cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
-                            builder.CreateCondBr(cmp, error_block, a);
+                for (size_t i = 0; i < code.size(); ++i)
+                {
+                    const auto& instruction = code[i];
+                    const auto& value = instruction.get_value();
 
-                            // The pop was successful, so switch to the next block and generate
-                            // the code to perform the jump based on the test value.
-                            builder.SetInsertPoint(a);
+                    bool is_variable =    value.is_string()
+                                       && (variables.find(value.get_string()) != variables.end());
 
-                            // Jump to the 'success' block if the test value is true, otherwise
-                            // jump to the 'fail' block.
-                            auto read_value = builder.CreateLoad(bool_type, test_value);
-                            builder.CreateCondBr(read_value, blocks[index], b);
-                            builder.SetInsertPoint(b);
-                        }
+                    // Parameters are the values taken off of the stack by the run of variable!
+                    // that starts the word.
+                    if (   (instruction.get_id() != Id::def_variable)
+                        && (instruction.get_id() != Id::write_variable)
+                        && ((instruction.get_id() != Id::execute) || !is_variable))
+                    {
+                        in_prologue = false;
+                    }
+
+                    switch (instruction.get_id())
+                    {
+                        case Id::def_variable:
+                        case Id::mark_loop_exit:
+                        case Id::unmark_loop_exit:
+                        case Id::mark_catch:
+                        case Id::unmark_catch:
+                        case Id::mark_context:
+                        case Id::release_context:
+                            break;
+
+                        case Id::def_constant:
+                        case Id::jump:
+                        case Id::jump_loop_start:
+                        case Id::jump_loop_exit:
+                        case Id::jump_target:
+                            spill();
+                            break;
+
+                        case Id::read_variable:
+                            if (top_is(Type::variable))
+                            {
+                                auto type = variables[stack.back().variable];
+
+                                stack.pop_back();
+                                push(type);
+                            }
+                            else
+                            {
+                                if (top_is(Type::int_value))
+                                {
+                                    stack.pop_back();
+                                }
+                                else
+                                {
+                                    spill();
+                                }
+
+                                push(Type::any);
+                            }
+                            break;
+
+                        case Id::write_variable:
+                            if (top_is(Type::variable))
+                            {
+                                auto name = stack.back().variable;
+                                stack.pop_back();
+
+                                if (!stack.empty() && (stack.back().type != Type::variable))
+                                {
+                                    update(name, stack.back().type);
+                                    stack.pop_back();
+                                }
+                                else if (stack.empty() && in_prologue)
+                                {
+                                    word_types.parameters[name] = { .depth = parameter_depth,
+                                                                    .write_index = i };
+                                    ++parameter_depth;
+                                }
+                                else
+                                {
+                                    spill();
+                                    update(name, Type::any);
+                                }
+                            }
+                            else
+                            {
+                                if (top_is(Type::int_value))
+                                {
+                                    stack.pop_back();
+                                }
+                                else
+                                {
+                                    spill();
+                                }
+
+                                if (!stack.empty() && (stack.back().type != Type::variable))
+                                {
+                                    stack.pop_back();
+                                }
+                                else
+                                {
+                                    spill();
+                                }
+                            }
+                            break;
+
+                        case Id::execute:
+                            if (value.is_string())
+                            {
+                                if (is_variable)
+                                {
+                                    stack.push_back({ .type = Type::variable,
+                                                      .variable = value.get_string(),
+                                                      .constant = nullptr });
+                                }
+                                else
+                                {
+                                    push(Type::any);
+                                }
+                            }
+                            else
+                            {
+                                auto index = value.get_int();
+                                const auto& word = collection.words[index];
+                                auto size = stack.size();
+
+                                auto numeric = collection.numeric_words.find(index);
+
+                                if (std::holds_alternative<NoExtraInfo>(word.extra_info))
+                                {
+                                    const auto& handler = word.handler_name;
+
+                                    // Temporary values can't be duplicated in place.
+                                    if ((handler == "word_dup") && (size >= 1)
+                                                                && !top_is(Type::any))
+                                    {
+                                        auto top = stack.back();
+
+                                        stack.push_back(top);
+                                        break;
+                                    }
+                                    else if ((handler == "word_over") && (size >= 2)
+                                                                      && !top_is(Type::any))
+                                    {
+                                        std::swap(stack[size - 1], stack[size - 2]);
+
+                                        auto second = stack[size - 2];
+
+                                        stack.push_back(second);
+                                        break;
+                                    }
+                                    else if ((handler == "word_drop") && (size >= 1))
+                                    {
+                                        stack.pop_back();
+                                        break;
+                                    }
+                                    else if ((handler == "word_swap") && (size >= 2))
+                                    {
+                                        std::swap(stack[size - 1], stack[size - 2]);
+                                        break;
+                                    }
+                                    else if ((handler == "word_rot") && (size >= 3))
+                                    {
+                                        std::rotate(stack.end() - 3, stack.end() - 1, stack.end());
+                                        break;
+                                    }
+                                    else if ((handler == "word_nip") && (size >= 2))
+                                    {
+                                        stack.erase(stack.end() - 2);
+                                        break;
+                                    }
+                                }
+
+                                if (numeric != collection.numeric_words.end())
+                                {
+                                    auto op = numeric->second;
+                                    auto count = std::min<size_t>(size, 2);
+
+                                    bool has_reference = false;
+
+                                    for (size_t j = 0; j < count; ++j)
+                                    {
+                                        has_reference |= stack[size - 1 - j].type == Type::variable;
+                                    }
+
+                                    if (!has_reference)
+                                    {
+                                        auto result = Type::any;
+
+                                        if (count == 2)
+                                        {
+                                            auto a = stack[size - 2];
+                                            auto b = stack[size - 1];
+
+                                            auto is_number = [](Type type)
+                                                {
+                                                    return    (type == Type::int_value)
+                                                           || (type == Type::double_value);
+                                                };
+
+                                            bool is_division =    (op == NumericOp::divide)
+                                                               || (op == NumericOp::mod);
+
+                                            bool safe_divisor =    (b.constant != nullptr)
+                                                                && (b.constant->is_int())
+                                                                && (b.constant->get_int() != 0)
+                                                                && (b.constant->get_int() != -1);
+
+                                            if (   (a.type == Type::pending)
+                                                || (b.type == Type::pending))
+                                            {
+                                                result = Type::pending;
+                                            }
+                                            else if (   (a.type == Type::int_value)
+                                                     && (b.type == Type::int_value)
+                                                     && (!is_division || safe_divisor))
+                                            {
+                                                result = is_comparison(op) ? Type::bool_value
+                                                                           : Type::int_value;
+                                            }
+                                            else if (   is_number(a.type)
+                                                     && is_number(b.type)
+                                                     && (op != NumericOp::mod)
+                                                     && (   (a.type == Type::double_value)
+                                                         || (b.type == Type::double_value)))
+                                            {
+                                                result = is_comparison(op) ? Type::bool_value
+                                                                           : Type::double_value;
+                                            }
+                                        }
+
+                                        stack.resize(size - count);
+
+                                        if (result == Type::any)
+                                        {
+                                            // The generated code checks the types at run-time,
+                                            // after writing out anything below the values.
+                                            spill();
+                                        }
+
+                                        push(result);
+                                        break;
+                                    }
+                                }
+
+                                // Otherwise the word is called and we lose track of the stack.
+                                spill();
+                            }
+                            break;
+
+                        case Id::word_index:
+                            push(Type::int_value);
+                            break;
+
+                        case Id::word_exists:
+                            push(Type::bool_value);
+                            break;
+
+                        case Id::push_constant_value:
+                            if (value.is_bool())
+                            {
+                                push(Type::bool_value, &value);
+                            }
+                            else if (value.is_int())
+                            {
+                                push(Type::int_value, &value);
+                            }
+                            else if (value.is_double())
+                            {
+                                push(Type::double_value, &value);
+                            }
+                            else
+                            {
+                                spill();
+                            }
+                            break;
+
+                        case Id::jump_if_zero:
+                        case Id::jump_if_not_zero:
+                            if (!stack.empty() && !top_is(Type::variable))
+                            {
+                                stack.pop_back();
+                            }
+
+                            spill();
+                            break;
+                    }
+                }
+
+                spill();
+            }
+
+            // Collect the variables that could be typed.  Variables that are only ever given a
+            // value by a parameter are assumed to be integers.
+            for (const auto& [ name, type ] : variables)
+            {
+                auto is_parameter = word_types.parameters.find(name) != word_types.parameters.end();
+
+                switch (type)
+                {
+                    case Type::int_value:
+                        word_types.variables[name] = VirtualStack::Kind::int_value;
                         break;
 
-                    case byte_code::Instruction::Id::jump_loop_start:
-                        {
-                            // Jump to the start block of the loop.
-                            auto start_index = loop_markers.back().first;
+                    case Type::double_value:
+                        word_types.variables[name] = VirtualStack::Kind::double_value;
+                        break;
 
-                            builder.CreateBr(blocks[start_index]);
-                            builder.SetInsertPoint(blocks[i]);
-                        }
+                    case Type::bool_value:
+                        word_types.variables[name] = VirtualStack::Kind::bool_value;
                         break;
 
-                    case byte_code::Instruction::Id::jump_loop_exit:
+                    case Type::pending:
+                        if (is_parameter)
                         {
-                            // Jump to the end block of the loop.
-                            auto end_index = loop_markers.back().second;
-                            builder.CreateBr(blocks[end_index]);
-                            builder.SetInsertPoint(blocks[i]);
+                            word_types.variables[name] = VirtualStack::Kind::int_value;
                         }
                         break;
 
-                    case byte_code::Instruction::Id::jump_target:
-                        // Make sure that the current block has a terminator instruction, if
-                        // not, add one to jump to the next block.  This is because this
-                        // would be a natural follow through in the original byte-code.
-                        if (builder.GetInsertBlock()->getTerminator() == nullptr)
+                    default:
+                        break;
+                }
+
+                if (word_types.variables.find(name) == word_types.variables.end())
+                {
+                    word_types.parameters.erase(name);
+                }
+            }
+
+            return word_types;
+        }
+
+
+        // Work out how many values a Forth word takes from the top of the stack before it does
+        // anything we can't follow, like calling another word or branching.  The count is capped
+        // to keep the number of specialized versions of a word reasonable.
+        size_t count_word_inputs(const WordCollection& collection,
+                                 const byte_code::ByteCode& code)
+        {
+            using Id = byte_code::Instruction::Id;
+
+            const size_t max_inputs = 4;
+
+            // The names that refer to the word's own variables and constants.
+            std::set<std::string> names;
+
+            for (const auto& instruction : code)
+            {
+                if (   (instruction.get_id() == Id::def_variable)
+                    || (instruction.get_id() == Id::def_constant))
+                {
+                    names.insert(instruction.get_value().get_string());
+                }
+            }
+
+            // How many of the values the word pushed are still on the stack, and how many values
+            // have been taken from the caller.
+            size_t depth = 0;
+            size_t inputs = 0;
+
+            auto pop = [&](size_t count)
+                {
+                    if (depth < count)
+                    {
+                        inputs += count - depth;
+                        depth = 0;
+                    }
+                    else
+                    {
+                        depth -= count;
+                    }
+                };
+
+            for (const auto& instruction : code)
+            {
+                const auto& value = instruction.get_value();
+
+                switch (instruction.get_id())
+                {
+                    case Id::def_variable:
+                    case Id::mark_context:
+                        break;
+
+                    case Id::def_constant:
+                        pop(1);
+                        break;
+
+                    case Id::read_variable:
+                        pop(1);
+                        ++depth;
+                        break;
+
+                    case Id::write_variable:
+                        pop(2);
+                        break;
+
+                    case Id::push_constant_value:
+                    case Id::word_index:
+                    case Id::word_exists:
+                        ++depth;
+                        break;
+
+                    case Id::execute:
+                        if (value.is_string())
                         {
-                            builder.CreateBr(blocks[i]);
+                            if (names.find(value.get_string()) == names.end())
+                            {
+                                return std::min(inputs, max_inputs);
+                            }
+
+                            ++depth;
+                        }
+                        else
+                        {
+                            auto index = value.get_int();
+                            const auto& word = collection.words[index];
+                            const auto& handler = word.handler_name;
+
+                            auto numeric = collection.numeric_words.find(index);
+
+                            if (numeric != collection.numeric_words.end())
+                            {
+                                pop(2);
+                                ++depth;
+                            }
+                            else if (!std::holds_alternative<NoExtraInfo>(word.extra_info))
+                            {
+                                return std::min(inputs, max_inputs);
+                            }
+                            else if (handler == "word_dup")
+                            {
+                                pop(1);
+                                depth += 2;
+                            }
+                            else if (handler == "word_drop")
+                            {
+                                pop(1);
+                            }
+                            else if ((handler == "word_swap") || (handler == "word_rot"))
+                            {
+                                auto count = handler == "word_swap" ? 2 : 3;
+
+                                pop(count);
+                                depth += count;
+                            }
+                            else if (handler == "word_over")
+                            {
+                                pop(2);
+                                depth += 3;
+                            }
+                            else if (handler == "word_nip")
+                            {
+                                pop(2);
+                                ++depth;
+                            }
+                            else
+                            {
+                                return std::min(inputs, max_inputs);
+                            }
                         }
+                        break;
+
+                    default:
+                        return std::min(inputs, max_inputs);
+                }
+            }
+
+            return std::min(inputs, max_inputs);
+        }
+
+
+        // Get the version of a Forth word specialized for the given types of values on the top of
+        // the stack.  If it hasn't been asked for before it's declared now and its code is
+        // generated later on.
+        llvm::Function* get_word_specialization(WordCollection& collection,
+                                                std::shared_ptr<llvm::Module>& module,
+                                                size_t index,
+                                                const std::vector<VirtualStack::Kind>& inputs)
+        {
+            const auto& word = collection.words[index];
+            auto name = word.handler_name;
+
+            for (auto input : inputs)
+            {
+                name += input == VirtualStack::Kind::double_value ? ".float"
+                      : input == VirtualStack::Kind::bool_value   ? ".bool"
+                                                                  : ".int";
+            }
+
+            auto iter = collection.specialization_map.find(name);
+
+            if (iter != collection.specialization_map.end())
+            {
+                return iter->second;
+            }
+
+            auto function = llvm::Function::Create(word.function->getFunctionType(),
+                                                   llvm::Function::InternalLinkage,
+                                                   name,
+                                                   module.get());
+
+            collection.specialization_map[name] = function;
+            collection.specializations.push_back({ .word_index = index,
+                                                   .inputs = inputs,
+                                                   .function = function });
+
+            return function;
+        }
+
+
+
+        // Generate the LLVM IR for a byte-code block.  This can be used for both Forth words and
+        // the top-level script code.
+        //
+        // The variables listed in word_types are kept unboxed.  If it turns out that one of them
+        // can't be, (for example its index is needed,) the function's body is thrown away and the
+        // names of those variables are returned so that the caller can try again without them.
+        std::set<std::string> generate_ir_for_byte_code(WordCollection& collection,
+                                                        const std::string& word_name,
+                                                        const byte_code::ByteCode& code,
+                                                        std::shared_ptr<llvm::Module>& module,
+                                                        llvm::LLVMContext& context,
+                                                        llvm::IRBuilder<>& builder,
+                                                        llvm::Function* function,
+                                                        GlobalMap& global_constant_map,
+                                                        const RuntimeApi& runtime_api,
+                                                        bool is_top_level,
+                                                        const WordTypes& word_types)
+        {
+            // Gather some types we'll need.
+            auto bool_type = llvm::Type::getInt1Ty(context);
+            auto int64_type = llvm::Type::getInt64Ty(context);
+            auto double_type = llvm::Type::getDoubleTy(context);
+            auto char_type = llvm::Type::getInt1Ty(context);
+            auto char_ptr_type = llvm::PointerType::getUnqual(char_type);
+
+            // Keep track of the variables and constants that are used in the byte-code block.
+            ValueMap variable_map;
+            std::unordered_map<std::string, llvm::AllocaInst*> constant_map;
+
+            // The names of the unboxed variables by their storage, and the names of any that turn
+            // out to need boxing after all.
+            std::unordered_map<llvm::Value*, std::string> unboxed_names;
+            std::set<std::string> boxed_variables;
+
+            size_t block_index = 1;
+
+            // Keep track of the basic blocks we create for the jump targets.
+            auto blocks = std::unordered_map<size_t, llvm::BasicBlock*>();
+            auto auto_jump_blocks = std::unordered_map<size_t, std::pair<llvm::BasicBlock*,
+                                                                         llvm::BasicBlock*>>();
+
+            auto var_read_blocks = std::unordered_map<size_t, std::tuple<llvm::BasicBlock*,
+                                                                         llvm::BasicBlock*,
+                                                                         llvm::BasicBlock*>>();
+
+            // Create the entry block of the function.
+            auto entry_block = llvm::BasicBlock::Create(context, "entry_block", function);
+            builder.SetInsertPoint(entry_block);
+
+            // If this is the top-level code we need to register all of the script structure types
+            // with the run-time.
+            if (is_top_level)
+            {
+                for (const auto& structure : collection.structures)
+                {
+                    auto struct_name = define_string_constant(structure.get_name(),
+                                                              builder,
+                                                              module,
+                                                              context);
+                    auto field_count = structure.get_field_names().size();
+                    auto field_count_const = llvm::ConstantInt::get(int64_type, field_count);
+
+                    auto char_ptr_array_type = llvm::ArrayType::get(char_ptr_type, field_count);
+
+                    auto name_array_variable = builder.CreateAlloca(char_ptr_array_type);
+
+                    for (size_t i = 0; i < field_count; ++i)
+                    {
+                        auto field_name = define_string_constant(structure.get_field_names()[i],
+                                                                builder,
+                                                                module,
+                                                                context);
+                        auto array_ptr = builder.CreateStructGEP(char_ptr_array_type,
+                                                                 name_array_variable,
+                                                                 i);
+                        builder.CreateStore(field_name, array_ptr);
+                    }
+
+                    auto iterator = collection.word_map.find(structure.get_name() +
+                                                             ".raw-init");
+
+                    if (iterator == collection.word_map.end())
+                    {
+                        throw std::runtime_error("Internal error, structure initializer not "
+                                                 "found.");
+                    }
+
+                    auto init_handler = collection.words[iterator->second].function;
+
+                    builder.CreateCall(runtime_api.register_structure_type,
+                                       {
+                                           struct_name,
+                                           name_array_variable,
+                                           field_count_const,
+                                           init_handler
+                                       });
+                }
+            }
+
+            // Keep track of any loop and catch block markers.
+            std::vector<std::pair<size_t, size_t>> loop_markers;
+            std::vector<size_t> catch_markers;
+
+            // Keep track of any jump targets that are the target of a catch block.
+            std::set<size_t> catch_target_markers;
+
+            // Initialize the return value to false.
+            auto return_value_variable = builder.CreateAlloca(bool_type);
+            builder.CreateStore(builder.getInt1(0), return_value_variable);
+
+            // First pass...
+            //
+            // Gather the variables and constants that are used in the byte-code block.  We'll need
+            // to generate the value variables for the variables and constants.  As well as
+            // variables to hold the variable indicies at run-time.
+            //
+            // Also, we'll need go through the byte-code and for every instruction that can cause a
+            // branch we'll need to create basic blocks for each of the possible branches.
+
+            size_t var_index = 0;
+
+            for (size_t i = 0; i < code.size(); ++i)
+            {
+                const auto& instruction = code[i];
+
+                switch (instruction.get_id())
+                {
+                    case byte_code::Instruction::Id::def_variable:
+                        {
+                            const auto& name = instruction.get_value().get_string();
+                            auto type_iter = word_types.variables.find(name);
+
+                            ValueInfo info;
+
+                            info.block_index = var_index;
+
+                            if (type_iter != word_types.variables.end())
+                            {
+                                auto type = get_scalar_type(builder, type_iter->second);
+
+                                info.variable = nullptr;
+                                info.variable_index = nullptr;
+                                info.unboxed_variable = builder.CreateAlloca(type);
+
+                                builder.CreateStore(llvm::Constant::getNullValue(type),
+                                                    info.unboxed_variable);
+
+                                unboxed_names[info.unboxed_variable] = name;
+                            }
+                            else
+                            {
+                                info.variable = builder.CreateAlloca(runtime_api.value_struct_type);
+                                info.variable_index = builder.CreateAlloca(int64_type);
+                                info.unboxed_variable = nullptr;
+
+                                builder.CreateCall(runtime_api.initialize_variable,
+                                                   { info.variable });
+                            }
+
+                            ++var_index;
+
+                            variable_map[name] = info;
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::def_constant:
+                        if (is_top_level)
+                        {
+                            llvm::Constant* zero_init =
+                                    llvm::ConstantAggregateZero::get(runtime_api.value_struct_type);
+
+                            auto constant = new llvm::GlobalVariable(*module,
+                                                                  runtime_api.value_struct_type,
+                                                                  false,
+                                                                  llvm::GlobalValue::PrivateLinkage,
+                                                                  zero_init);
+
+                            global_constant_map[instruction.get_value().get_string()] = constant;
+                            builder.CreateCall(runtime_api.initialize_variable, { constant });
+                        }
+                        else
+                        {
+                            auto const_variable =
+                                                builder.CreateAlloca(runtime_api.value_struct_type);
+
+                            constant_map[instruction.get_value().get_string()] = const_variable;
+                            builder.CreateCall(runtime_api.initialize_variable, { const_variable });
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::read_variable:
+                        {
+                            // Create the basic blocks for the instructions.
+                            std::stringstream stream;
+
+                            stream << "block_" << block_index;
+                            ++block_index;
+
+                            auto block_a = llvm::BasicBlock::Create(context,
+                                                                    stream.str(),
+                                                                    function);
+
+                            std::stringstream stream_b;
+
+                            stream_b << "block_" << block_index;
+                            ++block_index;
+
+                            auto block_b = llvm::BasicBlock::Create(context,
+                                                                    stream_b.str(),
+                                                                    function);
+
+                            var_read_blocks[i] = { block_a, block_b, nullptr };
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::write_variable:
+                        {
+                            std::stringstream stream;
+
+                            stream << "block_" << block_index;
+                            ++block_index;
+
+                            auto block_a = llvm::BasicBlock::Create(context,
+                                                                    stream.str(),
+                                                                    function);
+
+                            std::stringstream stream_b;
+
+                            stream_b << "block_" << block_index;
+                            ++block_index;
+
+                            auto block_b = llvm::BasicBlock::Create(context,
+                                                                    stream_b.str(),
+                                                                    function);
+
+                            std::stringstream stream_c;
+
+                            stream_c << "block_" << block_index;
+                            ++block_index;
+
+                            auto block_c = llvm::BasicBlock::Create(context,
+                                                                    stream_c.str(),
+                                                                    function);
+
+                            var_read_blocks[i] = { block_a, block_b, block_c };
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::execute:
+                    case byte_code::Instruction::Id::jump_loop_start:
+                    case byte_code::Instruction::Id::jump_loop_exit:
+                    case byte_code::Instruction::Id::jump_target:
+                        {
+                            // Create the basic blocks for the instructions.
+                            std::stringstream stream;
+
+                            stream << "block_" << block_index;
+                            ++block_index;
+
+                            blocks[i] =
+                                    llvm::BasicBlock::Create(context,
+                                                             stream.str(),
+                                                             builder.GetInsertBlock()->getParent());
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::jump_if_zero:
+                    case byte_code::Instruction::Id::jump_if_not_zero:
+                        {
+                            // These instructions have two jumps.  One jump for the pop error check
+                            // and one for the actual jump.  So we create two blocks for each of
+                            // these jump instructions.
+                            std::stringstream stream;
+
+                            stream << "block_" << block_index;
+                            ++block_index;
+
+                            auto block_a = llvm::BasicBlock::Create(context,
+                                                                    stream.str(),
+                                                                    function);
+
+                            std::stringstream stream_b;
+
+                            stream_b << "block_" << block_index;
+                            ++block_index;
+
+                            auto block_b = llvm::BasicBlock::Create(context,
+                                                                    stream_b.str(),
+                                                                    function);
+
+                            auto_jump_blocks[i] = { block_a, block_b };
+                        }
+                        break;
+
+                    default:
+                        // Nothing to do here.
+                        break;
+                }
+            }
+
+            // The word's code proper starts in it's own block.  That way once we've generated the
+            // code we can come back and add the variable registration to the entry block, if it
+            // turns out to be needed.
+            auto code_block = llvm::BasicBlock::Create(context,
+                                                       "code_block",
+                                                       function,
+                                                       entry_block->getNextNode());
+
+            if (word_types.parameters.empty())
+            {
+                builder.CreateBr(code_block);
+            }
+            else
+            {
+                // Some of the typed variables get their values from the word's parameters.  Make
+                // sure the parameters are of the right types, and if not run the generic version
+                // of the word instead.
+                const auto& layout = runtime_api.value_layout;
+
+                auto check_block = llvm::BasicBlock::Create(context, "check_parameters", function);
+                auto generic_block = llvm::BasicBlock::Create(context, "run_generic", function);
+
+                // The parameters sit below any inputs that a specialized version of the word takes
+                // off of the stack first.
+                auto input_count = word_types.inputs.size();
+                size_t max_depth = 0;
+
+                for (const auto& [ _, parameter ] : word_types.parameters)
+                {
+                    max_depth = std::max(max_depth, input_count + parameter.depth);
+                }
+
+                auto base_ptr = builder.CreateStructGEP(runtime_api.data_stack_type,
+                                                        runtime_api.data_stack,
+                                                        0);
+                auto top_ptr = builder.CreateStructGEP(runtime_api.data_stack_type,
+                                                       runtime_api.data_stack,
+                                                       1);
+
+                auto base = builder.CreateLoad(runtime_api.value_struct_ptr_type, base_ptr);
+                auto top = builder.CreateLoad(runtime_api.value_struct_ptr_type, top_ptr);
+
+                auto depth = builder.CreateSub(builder.CreatePtrToInt(top, int64_type),
+                                               builder.CreatePtrToInt(base, int64_type));
+                auto is_deep_enough = builder.CreateICmpUGE(depth,
+                                                   builder.getInt64((max_depth + 1) * layout.size));
+
+                builder.CreateCondBr(is_deep_enough, check_block, generic_block);
+
+                builder.SetInsertPoint(check_block);
+
+                llvm::Value* types_match = builder.getInt1(1);
+
+                for (const auto& [ name, parameter ] : word_types.parameters)
+                {
+                    auto kind = word_types.variables.at(name);
+                    auto tag = kind == VirtualStack::Kind::double_value ? layout.double_tag
+                             : kind == VirtualStack::Kind::bool_value   ? layout.bool_tag
+                                                                        : layout.int_tag;
+
+                    auto slot = builder.CreateConstInBoundsGEP1_64(runtime_api.value_struct_type,
+                                                                   top,
+                                                                   -(int64_t)(input_count +
+                                                                              parameter.depth) - 1);
+                    auto is_match = builder.CreateICmpEQ(generate_load_tag(builder,
+                                                                           runtime_api,
+                                                                           slot),
+                                                         builder.getInt8(tag));
+
+                    types_match = builder.CreateAnd(types_match, is_match);
+                }
+
+                builder.CreateCondBr(types_match, code_block, generic_block);
+
+                builder.SetInsertPoint(generic_block);
+
+                auto generic_result = builder.CreateCall(word_types.generic_function, {});
+                generic_result->setTailCall();
+                builder.CreateRet(generic_result);
+            }
+
+            builder.SetInsertPoint(code_block);
+
+            // Create the block to handle errors.
+            auto exit_error_block = llvm::BasicBlock::Create(context, "error_block", function);
+
+            // Create the end block of the function.
+            auto exit_block = llvm::BasicBlock::Create(context, "exit_block", function);
+
+            // Second pass...
+            //
+            // Now we can generate the LLVM IR for the byte-code block.  Values pushed within a
+            // block are tracked by the virtual stack and only written to the run-time stack when
+            // needed.
+            VirtualStack virtual_stack;
+
+            // A specialized version of the word starts by taking its inputs off of the stack.  Our
+            // caller has already made sure that they're there and of the right types.
+            if (!word_types.inputs.empty())
+            {
+                std::vector<llvm::Value*> input_values(word_types.inputs.size());
+
+                for (size_t j = input_values.size(); j > 0; --j)
+                {
+                    input_values[j - 1] = generate_pop_unchecked(builder,
+                                                                 runtime_api,
+                                                                 get_scalar_type(builder,
+                                                                        word_types.inputs[j - 1]));
+                }
+
+                for (size_t j = 0; j < input_values.size(); ++j)
+                {
+                    virtual_stack.push(word_types.inputs[j], input_values[j]);
+                }
+            }
+
+            // Jump to the catch block if there is one, or the exit block if not.  If we're holding
+            // values in the virtual stack they're written to the run-time stack on the way so that
+            // the error handler sees the same stack it would have without the optimization.
+            auto generate_error_branch = [&](llvm::Value* is_error, llvm::BasicBlock* next_block)
+                {
+                    auto error_block = catch_markers.empty()
+                                        ? exit_error_block
+                                        : blocks[catch_markers.back()];
+
+                    if (!virtual_stack.empty())
+                    {
+                        auto spill_block = llvm::BasicBlock::Create(context,
+                                                                    "error_spill",
+                                                                    function);
+
+                        create_unlikely_branch(builder, is_error, spill_block, next_block);
+
+                        builder.SetInsertPoint(spill_block);
+                        virtual_stack.generate_materialize(builder, runtime_api);
+                        builder.CreateBr(error_block);
+                    }
+                    else
+                    {
+                        create_unlikely_branch(builder, is_error, error_block, next_block);
+                    }
+
+                    builder.SetInsertPoint(next_block);
+                };
+
+            // Pop an index from the stack, either from the virtual stack if it's known, or from
+            // the run-time stack.
+            auto generate_pop_index = [&](llvm::BasicBlock* next_block) -> llvm::Value*
+                {
+                    if (virtual_stack.top_is(VirtualStack::Kind::int_value))
+                    {
+                        auto index = virtual_stack.pop().value;
+
+                        builder.CreateBr(next_block);
+                        builder.SetInsertPoint(next_block);
+
+                        return index;
+                    }
+
+                    virtual_stack.generate_spill(builder, runtime_api);
+
+                    auto [ index, pop_result ] = generate_pop_int(builder, runtime_api);
+                    auto cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
+
+                    generate_error_branch(cmp, next_block);
+
+                    return index;
+                };
+
+            // Is the instruction the last thing the word does?  That is, is it followed by nothing
+            // but jumps and markers that lead to the end of the word.
+            auto is_tail_position = [&](size_t index) -> bool
+                {
+                    size_t steps = 0;
+
+                    for (auto j = index + 1; j < code.size(); ++steps)
+                    {
+                        if (steps > code.size())
+                        {
+                            return false;
+                        }
+
+                        switch (code[j].get_id())
+                        {
+                            case byte_code::Instruction::Id::release_context:
+                            case byte_code::Instruction::Id::jump_target:
+                                ++j;
+                                break;
+
+                            case byte_code::Instruction::Id::jump:
+                                j += code[j].get_value().get_int();
+                                break;
+
+                            default:
+                                return false;
+                        }
+                    }
+
+                    return true;
+                };
+
+            // Calls to other Forth words made as the last thing this word does.  If it turns out
+            // that none of our variables escape, these become guaranteed tail calls once the rest
+            // of the word has been generated.
+            std::vector<llvm::CallInst*> tail_calls;
+
+            // Is the word the run-time's execute, which calls a word by it's index?
+            auto is_execute_word = [&](size_t index) -> bool
+                {
+                    const auto& word = collection.words[index];
+
+                    return    std::holds_alternative<NoExtraInfo>(word.extra_info)
+                           && (word.handler_name == "execute");
+                };
+
+            // Executing a word whose index is known at compile time, as in `word` execute, is the
+            // same as calling the word directly.  The index is tracked through the virtual stack
+            // like any other constant.  Returns the index of the word that will really be run.
+            auto resolve_execute_target = [&](size_t index) -> size_t
+                {
+                    while (   is_execute_word(index)
+                           && virtual_stack.top_is(VirtualStack::Kind::int_value))
+                    {
+                        auto constant = llvm::dyn_cast<llvm::ConstantInt>(
+                                                                    virtual_stack.peek(0).value);
+
+                        if (!constant)
+                        {
+                            break;
+                        }
+
+                        auto target = constant->getSExtValue();
+
+                        if (   (target < 0)
+                            || (static_cast<size_t>(target) >= collection.words.size())
+                            || !collection.words[target].was_referenced
+                            || (collection.words[target].function == nullptr))
+                        {
+                            break;
+                        }
+
+                        virtual_stack.pop();
+                        index = target;
+                    }
+
+                    return index;
+                };
+
+            // When the index isn't known, but only a handful of words ever have their index taken,
+            // check for each of them and call them directly.  Anything else still goes through the
+            // run-time's word table.
+            auto generate_execute_inline_cache = [&](llvm::Function* execute_function,
+                                                     llvm::BasicBlock* next_block) -> bool
+                {
+                    const size_t max_targets = 4;
+                    const auto& targets = collection.indexed_words;
+
+                    if (   targets.empty()
+                        || (targets.size() > max_targets))
+                    {
+                        return false;
+                    }
+
+                    for (auto target : targets)
+                    {
+                        if (collection.words[target].function == nullptr)
+                        {
+                            return false;
+                        }
+                    }
+
+                    auto popped_block = llvm::BasicBlock::Create(context,
+                                                                 "execute_popped",
+                                                                 function);
+                    auto miss_block = llvm::BasicBlock::Create(context, "execute_miss", function);
+                    auto done_block = llvm::BasicBlock::Create(context, "execute_done", function);
+
+                    auto index = generate_pop_index(popped_block);
+
+                    virtual_stack.generate_spill(builder, runtime_api);
+
+                    auto switch_inst = builder.CreateSwitch(index, miss_block, targets.size());
+                    std::vector<std::pair<llvm::Value*, llvm::BasicBlock*>> results;
+
+                    for (auto target : targets)
+                    {
+                        auto hit_block = llvm::BasicBlock::Create(context, "execute_hit", function);
+
+                        switch_inst->addCase(builder.getInt64(target), hit_block);
+
+                        builder.SetInsertPoint(hit_block);
+                        results.push_back({ builder.CreateCall(collection.words[target].function,
+                                                               {}),
+                                            hit_block });
+                        builder.CreateBr(done_block);
+                    }
+
+                    // Not one of the words we know of, hand the index back to the run-time.
+                    builder.SetInsertPoint(miss_block);
+                    generate_push_int(builder, runtime_api, index);
+                    results.push_back({ builder.CreateCall(execute_function, {}),
+                                        builder.GetInsertBlock() });
+                    builder.CreateBr(done_block);
+
+                    builder.SetInsertPoint(done_block);
+
+                    auto result = builder.CreatePHI(builder.getInt1Ty(), results.size());
+
+                    for (const auto& [ value, block ] : results)
+                    {
+                        result->addIncoming(value, block);
+                    }
+
+                    auto cmp = builder.CreateICmpNE(result, builder.getInt1(0));
+                    generate_error_branch(cmp, next_block);
+
+                    return true;
+                };
+
+            // Pop a test value for a conditional jump.
+            auto generate_pop_test = [&](llvm::BasicBlock* next_block) -> llvm::Value*
+                {
+                    if (virtual_stack.top_is_scalar())
+                    {
+                        auto test_value = generate_entry_to_bool(builder, virtual_stack.pop());
+
+                        builder.CreateBr(next_block);
+                        builder.SetInsertPoint(next_block);
+
+                        return test_value;
+                    }
+
+                    // A temporary that holds a bool can be tested in place, anything else is
+                    // handed to the run-time to convert.
+                    if (virtual_stack.top_is(VirtualStack::Kind::value))
+                    {
+                        virtual_stack.generate_spill_below(builder, runtime_api, 1);
+
+                        auto variable_temp = virtual_stack.pop().value;
+
+                        auto fast_block = llvm::BasicBlock::Create(context, "test_fast", function);
+                        auto slow_block = llvm::BasicBlock::Create(context, "test_slow", function);
+                        auto popped_block = llvm::BasicBlock::Create(context,
+                                                                     "test_popped",
+                                                                     function);
+
+                        auto tag = generate_load_tag(builder, runtime_api, variable_temp);
+                        auto is_bool = builder.CreateICmpEQ(tag,
+                                                    builder.getInt8(runtime_api.value_layout.bool_tag));
+                        builder.CreateCondBr(is_bool, fast_block, slow_block);
+
+                        builder.SetInsertPoint(fast_block);
+
+                        auto raw_value = builder.CreateLoad(builder.getInt8Ty(),
+                                            value_field_ptr(builder,
+                                                            variable_temp,
+                                                            runtime_api.value_layout.data_offset));
+                        auto fast_value = builder.CreateICmpNE(raw_value, builder.getInt8(0));
+                        builder.CreateBr(next_block);
+
+                        builder.SetInsertPoint(slow_block);
+                        builder.CreateCall(runtime_api.stack_push_move, { variable_temp });
+
+                        auto [ slow_value, pop_result ] = generate_pop_bool(builder, runtime_api);
+                        auto cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
+
+                        generate_error_branch(cmp, popped_block);
+                        builder.CreateBr(next_block);
+
+                        builder.SetInsertPoint(next_block);
+
+                        auto test_value = builder.CreatePHI(bool_type, 2);
+                        test_value->addIncoming(fast_value, fast_block);
+                        test_value->addIncoming(slow_value, popped_block);
+
+                        return test_value;
+                    }
+
+                    virtual_stack.generate_spill(builder, runtime_api);
+
+                    auto [ test_value, pop_result ] = generate_pop_bool(builder, runtime_api);
+                    auto cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
+
+                    generate_error_branch(cmp, next_block);
+
+                    return test_value;
+                };
+
+            // Perform one of the numeric words inline.  If both values are numbers the operation
+            // is done directly, otherwise we fall back to calling the word itself, which knows how
+            // to deal with strings and the other types.  Returns false if the word needs to be
+            // called as normal.
+            auto generate_numeric_word = [&](NumericOp op,
+                                             llvm::Function* word_function,
+                                             llvm::BasicBlock* next_block) -> bool
+                {
+                    const auto& layout = runtime_api.value_layout;
+
+                    auto is_int = [](const VirtualStack::Entry& entry)
+                        {
+                            return entry.kind == VirtualStack::Kind::int_value;
+                        };
+
+                    auto is_double = [](const VirtualStack::Entry& entry)
+                        {
+                            return entry.kind == VirtualStack::Kind::double_value;
+                        };
+
+                    // Work out how many of the values are in the virtual stack.  References to our
+                    // variables are left for the word itself.
+                    auto known_count = std::min<size_t>(virtual_stack.size(), 2);
+
+                    for (size_t i = 0; i < known_count; ++i)
+                    {
+                        auto kind = virtual_stack.peek(i).kind;
+
+                        if (   (kind == VirtualStack::Kind::variable)
+                            || (kind == VirtualStack::Kind::typed_variable))
+                        {
+                            return false;
+                        }
+                    }
+
+                    // If both values are numbers held in registers there's nothing to check at
+                    // run-time.  Integer division still has to be checked for a zero divisor, and
+                    // the run-time only performs mod on integers.
+                    if (known_count == 2)
+                    {
+                        const auto& b = virtual_stack.peek(0);
+                        const auto& a = virtual_stack.peek(1);
+
+                        bool both_int = is_int(a) && is_int(b);
+                        bool both_numeric =    (is_int(a) || is_double(a))
+                                            && (is_int(b) || is_double(b));
+
+                        // Integer division can only be folded if the divisor is a constant
+                        // that can't fault.
+                        auto divisor = llvm::dyn_cast<llvm::ConstantInt>(b.value);
+                        bool safe_divisor =    (divisor != nullptr)
+                                            && (!divisor->isZero())
+                                            && (!divisor->isMinusOne());
+
+                        bool can_fold = both_int
+                                        ?    ((op != NumericOp::divide) && (op != NumericOp::mod))
+                                          || safe_divisor
+                                        : both_numeric && (op != NumericOp::mod);
+
+                        if (can_fold)
+                        {
+                            auto b_entry = virtual_stack.pop();
+                            auto a_entry = virtual_stack.pop();
+
+                            auto to_double = [&](const VirtualStack::Entry& entry)
+                                {
+                                    return is_int(entry)
+                                           ? builder.CreateSIToFP(entry.value, double_type)
+                                           : entry.value;
+                                };
+
+                            auto kind = is_comparison(op) ? VirtualStack::Kind::bool_value
+                                      : both_int          ? VirtualStack::Kind::int_value
+                                                          : VirtualStack::Kind::double_value;
+
+                            auto result = both_int
+                                          ? generate_int_op(builder,
+                                                            op,
+                                                            a_entry.value,
+                                                            b_entry.value)
+                                          : generate_double_op(builder,
+                                                               op,
+                                                               to_double(a_entry),
+                                                               to_double(b_entry));
+
+                            virtual_stack.push(kind, result);
+
+                            builder.CreateBr(next_block);
+                            builder.SetInsertPoint(next_block);
+
+                            return true;
+                        }
+                    }
+
+                    // Otherwise check the types at run-time.  Any values below the ones we're
+                    // working with are written out first so that on the slow path the word sees
+                    // the stack in the right order.
+                    virtual_stack.generate_spill_below(builder, runtime_api, known_count);
+
+                    std::vector<VirtualStack::Entry> known_operands(known_count);
+
+                    for (size_t i = 0; i < known_count; ++i)
+                    {
+                        known_operands[known_count - 1 - i] = virtual_stack.pop();
+                    }
+
+                    // The rest of the values are on the run-time stack.
+                    auto stack_count = 2 - known_count;
+
+                    auto check_block = llvm::BasicBlock::Create(context, "numeric_check", function);
+                    auto int_block = llvm::BasicBlock::Create(context, "numeric_int", function);
+                    auto double_check_block = llvm::BasicBlock::Create(context,
+                                                                       "numeric_double_check",
+                                                                       function);
+                    auto slow_block = llvm::BasicBlock::Create(context, "numeric_slow", function);
+                    auto slow_done_block = llvm::BasicBlock::Create(context,
+                                                                    "numeric_slow_done",
+                                                                    function);
+                    auto done_block = llvm::BasicBlock::Create(context, "numeric_done", function);
+
+                    auto result_temp = create_entry_alloca(builder, runtime_api.value_struct_type);
+
+                    llvm::Value* top_ptr = nullptr;
+                    llvm::Value* top = nullptr;
+
+                    if (stack_count > 0)
+                    {
+                        // Make sure the run-time stack is deep enough before we look at it.
+                        auto base_ptr = builder.CreateStructGEP(runtime_api.data_stack_type,
+                                                                runtime_api.data_stack,
+                                                                0);
+                        top_ptr = builder.CreateStructGEP(runtime_api.data_stack_type,
+                                                          runtime_api.data_stack,
+                                                          1);
+
+                        auto base = builder.CreateLoad(runtime_api.value_struct_ptr_type, base_ptr);
+                        top = builder.CreateLoad(runtime_api.value_struct_ptr_type, top_ptr);
+
+                        auto depth = builder.CreateSub(builder.CreatePtrToInt(top, int64_type),
+                                                       builder.CreatePtrToInt(base, int64_type));
+                        auto is_deep_enough = builder.CreateICmpUGE(depth,
+                                                    builder.getInt64(stack_count * layout.size));
+
+                        builder.CreateCondBr(is_deep_enough, check_block, slow_block);
+                    }
+                    else
+                    {
+                        builder.CreateBr(check_block);
+                    }
+
+                    // Gather the type tags and the payloads of both values.
+                    builder.SetInsertPoint(check_block);
+
+                    struct Operand
+                    {
+                        llvm::Value* tag;
+                        llvm::Value* int_value;
+                        llvm::Value* double_value;
+                    };
+
+                    std::vector<Operand> operands;
+
+                    for (size_t i = 0; i < 2; ++i)
+                    {
+                        llvm::Value* variable = nullptr;
+
+                        if (i < stack_count)
+                        {
+                            variable = builder.CreateConstInBoundsGEP1_64(
+                                                                    runtime_api.value_struct_type,
+                                                                    top,
+                                                                    i - stack_count);
+                        }
+                        else
+                        {
+                            const auto& entry = known_operands[i - stack_count];
+
+                            switch (entry.kind)
+                            {
+                                case VirtualStack::Kind::int_value:
+                                    operands.push_back({ builder.getInt8(layout.int_tag),
+                                                         entry.value,
+                                                         llvm::ConstantFP::get(double_type, 0.0) });
+                                    continue;
+
+                                case VirtualStack::Kind::double_value:
+                                    operands.push_back({ builder.getInt8(layout.double_tag),
+                                                         builder.getInt64(0),
+                                                         entry.value });
+                                    continue;
+
+                                case VirtualStack::Kind::bool_value:
+                                    operands.push_back({ builder.getInt8(layout.bool_tag),
+                                                         builder.getInt64(0),
+                                                         llvm::ConstantFP::get(double_type, 0.0) });
+                                    continue;
+
+                                default:
+                                    variable = entry.value;
+                                    break;
+                            }
+                        }
+
+                        auto data_ptr = value_field_ptr(builder, variable, layout.data_offset);
+
+                        operands.push_back({ generate_load_tag(builder, runtime_api, variable),
+                                             builder.CreateLoad(int64_type, data_ptr),
+                                             builder.CreateLoad(double_type, data_ptr) });
+                    }
+
+                    const auto& a = operands[0];
+                    const auto& b = operands[1];
+
+                    auto int_tag = builder.getInt8(layout.int_tag);
+                    auto double_tag = builder.getInt8(layout.double_tag);
+
+                    auto a_is_int = builder.CreateICmpEQ(a.tag, int_tag);
+                    auto b_is_int = builder.CreateICmpEQ(b.tag, int_tag);
+                    auto both_int = builder.CreateAnd(a_is_int, b_is_int);
+
+                    auto int_is_safe = both_int;
+
+                    if ((op == NumericOp::divide) || (op == NumericOp::mod))
+                    {
+                        int_is_safe = builder.CreateAnd(both_int,
+                                                        generate_division_is_safe(builder,
+                                                                                  a.int_value,
+                                                                                  b.int_value));
+                    }
+
+                    builder.CreateCondBr(int_is_safe, int_block, double_check_block);
+
+                    // Pop any values we used from the run-time stack, then store the result.
+                    auto generate_fast_result = [&](llvm::Value* result, uint8_t tag)
+                        {
+                            if (stack_count > 0)
+                            {
+                                auto new_top = builder.CreateConstInBoundsGEP1_64(
+                                                                    runtime_api.value_struct_type,
+                                                                    top,
+                                                                    -(int64_t)stack_count);
+                                builder.CreateStore(new_top, top_ptr);
+                            }
+
+                            generate_store_scalar(builder, runtime_api, result_temp, result, tag);
+                            builder.CreateBr(done_block);
+                        };
+
+                    // Both values are ints.
+                    builder.SetInsertPoint(int_block);
+                    generate_fast_result(generate_int_op(builder, op, a.int_value, b.int_value),
+                                         is_comparison(op) ? layout.bool_tag : layout.int_tag);
+
+                    // If either of the values is a float, and the other is a number, the
+                    // operation is performed on floats.
+                    builder.SetInsertPoint(double_check_block);
+
+                    if (op != NumericOp::mod)
+                    {
+                        auto double_block = llvm::BasicBlock::Create(context,
+                                                                     "numeric_double",
+                                                                     function);
+
+                        auto a_is_numeric = builder.CreateOr(a_is_int,
+                                                             builder.CreateICmpEQ(a.tag,
+                                                                                  double_tag));
+                        auto b_is_numeric = builder.CreateOr(b_is_int,
+                                                             builder.CreateICmpEQ(b.tag,
+                                                                                  double_tag));
+                        auto use_double = builder.CreateAnd(builder.CreateAnd(a_is_numeric,
+                                                                              b_is_numeric),
+                                                            builder.CreateNot(both_int));
+
+                        builder.CreateCondBr(use_double, double_block, slow_block);
+
+                        builder.SetInsertPoint(double_block);
+
+                        auto a_double = builder.CreateSelect(a_is_int,
+                                                             builder.CreateSIToFP(a.int_value,
+                                                                                  double_type),
+                                                             a.double_value);
+                        auto b_double = builder.CreateSelect(b_is_int,
+                                                             builder.CreateSIToFP(b.int_value,
+                                                                                  double_type),
+                                                             b.double_value);
+
+                        generate_fast_result(generate_double_op(builder, op, a_double, b_double),
+                                             is_comparison(op) ? layout.bool_tag
+                                                               : layout.double_tag);
+                    }
+                    else
+                    {
+                        builder.CreateBr(slow_block);
+                    }
+
+                    // Anything else is up to the word itself.  The values we were tracking are
+                    // written to the run-time stack and the word is called as normal.
+                    builder.SetInsertPoint(slow_block);
+
+                    for (const auto& entry : known_operands)
+                    {
+                        virtual_stack.generate_push_entry(builder, runtime_api, entry);
+                    }
+
+                    auto result = builder.CreateCall(word_function, {});
+                    auto cmp = builder.CreateICmpNE(result, builder.getInt1(0));
+
+                    generate_error_branch(cmp, slow_done_block);
+
+                    builder.CreateCall(runtime_api.stack_pop_move, { result_temp });
+                    builder.CreateBr(done_block);
+
+                    // Either way the result is now in our temporary.
+                    builder.SetInsertPoint(done_block);
+                    virtual_stack.push(VirtualStack::Kind::value, result_temp);
+
+                    builder.CreateBr(next_block);
+                    builder.SetInsertPoint(next_block);
+
+                    return true;
+                };
+
+            // Get the handler name of a run-time word executed by an instruction, or an empty
+            // string if the instruction isn't a call to one of the run-time's words.
+            auto runtime_handler = [&](size_t index) -> std::string
+                {
+                    if (   (index >= code.size())
+                        || (code[index].get_id() != byte_code::Instruction::Id::execute)
+                        || (!code[index].get_value().is_numeric()))
+                    {
+                        return "";
+                    }
+
+                    auto word_index = code[index].get_value().get_int();
+
+                    if (   (word_index < 0)
+                        || (static_cast<size_t>(word_index) >= collection.words.size())
+                        || (!std::holds_alternative<NoExtraInfo>(
+                                                        collection.words[word_index].extra_info)))
+                    {
+                        return "";
+                    }
+
+                    return collection.words[word_index].handler_name;
+                };
+
+            // Link up the blocks that were created for an instruction that has been folded into a
+            // superinstruction.  The code for the following instructions expects to continue on
+            // from them.
+            auto generate_skipped_instruction = [&](size_t index)
+                {
+                    switch (code[index].get_id())
+                    {
+                        case byte_code::Instruction::Id::read_variable:
+                        case byte_code::Instruction::Id::write_variable:
+                            {
+                                auto [ block_a, block_b, block_c ] = var_read_blocks[index];
+
+                                for (auto block : { block_a, block_b, block_c })
+                                {
+                                    if (block != nullptr)
+                                    {
+                                        builder.CreateBr(block);
+                                        builder.SetInsertPoint(block);
+                                    }
+                                }
+                            }
+                            break;
+
+                        case byte_code::Instruction::Id::execute:
+                            builder.CreateBr(blocks[index]);
+                            builder.SetInsertPoint(blocks[index]);
+                            break;
+
+                        default:
+                            break;
+                    }
+                };
+
+            // Write a known value to a value variable so that it can be passed to the run-time.
+            // Temporaries are passed as they are.
+            auto generate_operand_value = [&](const VirtualStack::Entry& entry) -> llvm::Value*
+                {
+                    if (entry.kind == VirtualStack::Kind::value)
+                    {
+                        return entry.value;
+                    }
+
+                    auto variable_temp = create_entry_alloca(builder, runtime_api.value_struct_type);
+                    builder.CreateCall(runtime_api.initialize_variable, { variable_temp });
+                    generate_entry_to_value(builder, runtime_api, entry, variable_temp);
+
+                    return variable_temp;
+                };
+
+            // Free the operands that were passed to the run-time, if they were temporaries that
+            // owned their values.
+            auto generate_free_operands = [&](const std::vector<VirtualStack::Entry>& operands)
+                {
+                    for (const auto& entry : operands)
+                    {
+                        if (entry.kind == VirtualStack::Kind::value)
+                        {
+                            builder.CreateCall(runtime_api.free_variable, { entry.value });
+                        }
+                    }
+                };
+
+            // Check if the code starting at the given instruction is one of the common sequences
+            // that we know how to perform as a single operation.  Returns the number of
+            // instructions that were handled, or zero if the code should be generated as normal.
+            auto generate_superinstruction = [&](size_t index) -> size_t
+                {
+                    auto is_operand = [&](size_t depth)
+                        {
+                            if (virtual_stack.size() <= depth)
+                            {
+                                return false;
+                            }
+
+                            auto kind = virtual_stack.peek(depth).kind;
+
+                            return    (kind != VirtualStack::Kind::variable)
+                                   && (kind != VirtualStack::Kind::typed_variable);
+                        };
+
+                    auto is_index = [&](size_t depth)
+                        {
+                            return    (virtual_stack.size() > depth)
+                                   && (virtual_stack.peek(depth).kind
+                                                               == VirtualStack::Kind::int_value);
+                        };
+
+                    // The start of a loop is reached by branching to the block of the first
+                    // instruction in its body, so a sequence can't run over one.
+                    auto is_straight_line = [&](size_t count)
+                        {
+                            for (size_t j = index; j < index + count; ++j)
+                            {
+                                if (   (j > 0)
+                                    && (code[j - 1].get_id()
+                                                    == byte_code::Instruction::Id::mark_loop_exit))
+                                {
+                                    return false;
+                                }
+                            }
+
+                            return true;
+                        };
+
+                    // A container held in one of our boxed variables is accessed in place,
+                    // instead of copying it out of the variable to hand it to the word:
+                    //
+                    //     index array @ []@       value index array @ []!
+                    //     key table @ {}@         value key table @ {}!
+                    if (   (code[index].get_id() == byte_code::Instruction::Id::execute)
+                        && (code[index].get_value().is_string())
+                        && (index + 2 < code.size())
+                        && (code[index + 1].get_id() == byte_code::Instruction::Id::read_variable)
+                        && is_straight_line(3))
+                    {
+                        auto var_iter = variable_map.find(code[index].get_value().get_string());
+                        auto handler = runtime_handler(index + 2);
+
+                        if (   (var_iter == variable_map.end())
+                            || (var_iter->second.unboxed_variable != nullptr))
+                        {
+                            return 0;
+                        }
+
+                        auto variable = var_iter->second.variable;
+
+                        llvm::Function* fused_function = nullptr;
+                        std::vector<llvm::Value*> arguments = { variable };
+                        std::vector<VirtualStack::Entry> operands;
+                        llvm::Value* output = nullptr;
+
+                        if ((handler == "word_array_read_index") && is_index(0))
+                        {
+                            fused_function = runtime_api.variable_array_read;
+                            arguments.push_back(virtual_stack.pop().value);
+                        }
+                        else if (   (handler == "word_array_write_index")
+                                 && is_index(0)
+                                 && is_operand(1))
+                        {
+                            fused_function = runtime_api.variable_array_write;
+                            arguments.push_back(virtual_stack.pop().value);
+
+                            operands.push_back(virtual_stack.pop());
+                            arguments.push_back(generate_operand_value(operands.back()));
+                        }
+                        else if ((handler == "word_hash_table_find") && is_operand(0))
+                        {
+                            fused_function = runtime_api.variable_hash_table_read;
+
+                            operands.push_back(virtual_stack.pop());
+                            arguments.push_back(generate_operand_value(operands.back()));
+                        }
+                        else if (   (handler == "word_hash_table_insert")
+                                 && is_operand(0)
+                                 && is_operand(1))
+                        {
+                            fused_function = runtime_api.variable_hash_table_write;
+
+                            operands.push_back(virtual_stack.pop());
+                            arguments.push_back(generate_operand_value(operands.back()));
+
+                            operands.push_back(virtual_stack.pop());
+                            arguments.push_back(generate_operand_value(operands.back()));
+                        }
+                        else
+                        {
+                            return 0;
+                        }
+
+                        if (   (fused_function == runtime_api.variable_array_read)
+                            || (fused_function == runtime_api.variable_hash_table_read))
+                        {
+                            output = create_entry_alloca(builder, runtime_api.value_struct_type);
+                            builder.CreateCall(runtime_api.initialize_variable, { output });
+                            arguments.push_back(output);
+                        }
+
+                        auto done_block = llvm::BasicBlock::Create(context, "fused_done", function);
+
+                        auto result = builder.CreateCall(fused_function, arguments);
+                        generate_free_operands(operands);
+
+                        auto cmp = builder.CreateICmpNE(result, builder.getInt1(0));
+                        generate_error_branch(cmp, done_block);
+
+                        if (output != nullptr)
+                        {
+                            virtual_stack.push(VirtualStack::Kind::value, output);
+                        }
+
+                        for (size_t j = index; j < index + 3; ++j)
+                        {
+                            generate_skipped_instruction(j);
+                        }
+
+                        return 3;
+                    }
+
+                    // Incrementing or decrementing one of our boxed variables, as ++! and --! do
+                    // once they've been inlined, is done in place if it's holding an int:
+                    //
+                    //     variable dup @ 1 + swap !
+                    if (   (runtime_handler(index) == "word_dup")
+                        && virtual_stack.top_is(VirtualStack::Kind::variable)
+                        && (index + 5 < code.size())
+                        && (code[index + 1].get_id() == byte_code::Instruction::Id::read_variable)
+                        && (code[index + 2].get_id()
+                                              == byte_code::Instruction::Id::push_constant_value)
+                        && (code[index + 2].get_value().is_int())
+                        && (code[index + 3].get_id() == byte_code::Instruction::Id::execute)
+                        && (code[index + 3].get_value().is_numeric())
+                        && (runtime_handler(index + 4) == "word_swap")
+                        && (code[index + 5].get_id() == byte_code::Instruction::Id::write_variable)
+                        && is_straight_line(6))
+                    {
+                        auto word_index = code[index + 3].get_value().get_int();
+                        auto numeric_iter = collection.numeric_words.find(word_index);
+
+                        if (   (numeric_iter == collection.numeric_words.end())
+                            || (   (numeric_iter->second != NumericOp::add)
+                                && (numeric_iter->second != NumericOp::subtract)))
+                        {
+                            return 0;
+                        }
+
+                        const auto& layout = runtime_api.value_layout;
+
+                        auto amount = code[index + 2].get_value().get_int();
+                        auto variable = virtual_stack.pop().value;
+
+                        auto fast_block = llvm::BasicBlock::Create(context,
+                                                                   "increment_fast",
+                                                                   function);
+                        auto slow_block = llvm::BasicBlock::Create(context,
+                                                                   "increment_slow",
+                                                                   function);
+                        auto popped_block = llvm::BasicBlock::Create(context,
+                                                                     "increment_popped",
+                                                                     function);
+                        auto done_block = llvm::BasicBlock::Create(context,
+                                                                   "increment_done",
+                                                                   function);
+
+                        auto tag = generate_load_tag(builder, runtime_api, variable);
+                        auto is_int = builder.CreateICmpEQ(tag, builder.getInt8(layout.int_tag));
+
+                        builder.CreateCondBr(is_int, fast_block, slow_block);
+
+                        builder.SetInsertPoint(fast_block);
+
+                        auto data_ptr = value_field_ptr(builder, variable, layout.data_offset);
+                        auto old_value = builder.CreateLoad(int64_type, data_ptr);
+                        auto new_value = generate_int_op(builder,
+                                                         numeric_iter->second,
+                                                         old_value,
+                                                         builder.getInt64(amount));
+
+                        builder.CreateStore(new_value, data_ptr);
+                        builder.CreateBr(done_block);
+
+                        // Anything else is up to the word itself, just as it would have been
+                        // without the superinstruction.
+                        builder.SetInsertPoint(slow_block);
+                        builder.CreateCall(runtime_api.stack_push, { variable });
+                        generate_push_int(builder, runtime_api, builder.getInt64(amount));
+
+                        auto result = builder.CreateCall(collection.words[word_index].function,
+                                                         {});
+                        auto cmp = builder.CreateICmpNE(result, builder.getInt1(0));
+
+                        generate_error_branch(cmp, popped_block);
+
+                        builder.CreateCall(runtime_api.stack_pop, { variable });
+                        builder.CreateBr(done_block);
+
+                        builder.SetInsertPoint(done_block);
+
+                        for (size_t j = index; j < index + 6; ++j)
+                        {
+                            generate_skipped_instruction(j);
+                        }
+
+                        return 6;
+                    }
+
+                    return 0;
+                };
+
+            for (size_t i = 0; i < code.size(); ++i)
+            {
+                const auto& instruction = code[i];
+
+                auto fused_count = generate_superinstruction(i);
+
+                if (fused_count > 0)
+                {
+                    i += fused_count - 1;
+                    continue;
+                }
+
+                switch (instruction.get_id())
+                {
+                    case byte_code::Instruction::Id::def_variable:
+                        // Nothing to do here...  The variable has already been allocated and
+                        // initialized to a default state.
+                        break;
+
+                    case byte_code::Instruction::Id::def_constant:
+                        {
+                            auto name = instruction.get_value().get_string();
+                            auto iterator = constant_map.find(name);
+
+                            llvm::Value* constant = nullptr;
+
+                            if (iterator != constant_map.end())
+                            {
+                                constant = iterator->second;
+                            }
+                            else
+                            {
+                                constant = global_constant_map[name];
+                            }
+
+                            // Pop the value for the new constant off of the stack.
+                            virtual_stack.generate_spill(builder, runtime_api);
+                            builder.CreateCall(runtime_api.stack_pop, { constant });
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::read_variable:
+                        {
+                            auto [ next_block_a, next_block_b, _ ] = var_read_blocks[i];
+
+                            // Unboxed variables are simply loaded.
+                            if (virtual_stack.top_is(VirtualStack::Kind::typed_variable))
+                            {
+                                auto variable = virtual_stack.pop().value;
+                                auto kind = word_types.variables.at(unboxed_names[variable]);
+
+                                builder.CreateBr(next_block_a);
+                                builder.SetInsertPoint(next_block_a);
+
+                                auto value = builder.CreateLoad(get_scalar_type(builder, kind),
+                                                                variable);
+
+                                builder.CreateBr(next_block_b);
+                                builder.SetInsertPoint(next_block_b);
+
+                                virtual_stack.push(kind, value);
+                                break;
+                            }
+
+                            // If we know which of our variables is being read we can copy it
+                            // directly.
+                            if (virtual_stack.top_is(VirtualStack::Kind::variable))
+                            {
+                                auto variable = virtual_stack.pop().value;
+
+                                builder.CreateBr(next_block_a);
+                                builder.SetInsertPoint(next_block_a);
+
+                                auto variable_temp = create_entry_alloca(builder,
+                                                                  runtime_api.value_struct_type);
+                                builder.CreateCall(runtime_api.initialize_variable,
+                                                   { variable_temp });
+                                generate_copy_value(builder,
+                                                    runtime_api,
+                                                    variable,
+                                                    variable_temp,
+                                                    false);
+
+                                builder.CreateBr(next_block_b);
+                                builder.SetInsertPoint(next_block_b);
+
+                                virtual_stack.push(VirtualStack::Kind::value, variable_temp);
+                                break;
+                            }
+
+                            auto index = generate_pop_index(next_block_a);
+
+                            auto variable_temp = create_entry_alloca(builder,
+                                                                  runtime_api.value_struct_type);
+                            builder.CreateCall(runtime_api.initialize_variable, { variable_temp });
+
+                            auto read_result = builder.CreateCall(runtime_api.read_variable,
+                                                                  { index, variable_temp });
+
+                            auto cmp = builder.CreateICmpNE(read_result, builder.getInt1(0));
+                            generate_error_branch(cmp, next_block_b);
+
+                            // The temporary now belongs to the virtual stack, it will be freed
+                            // when it's consumed or written to the run-time stack.
+                            virtual_stack.push(VirtualStack::Kind::value, variable_temp);
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::write_variable:
+                        {
+                            auto [ next_block_a, next_block_b, next_block_c ] = var_read_blocks[i];
+
+                            // Unboxed variables are simply stored to.  The type inference made
+                            // sure that the value is of the variable's type, or that it's one of
+                            // the parameters that were checked as the word started.
+                            if (virtual_stack.top_is(VirtualStack::Kind::typed_variable))
+                            {
+                                auto variable = virtual_stack.pop().value;
+                                const auto& name = unboxed_names[variable];
+                                auto kind = word_types.variables.at(name);
+                                auto parameter = word_types.parameters.find(name);
+
+                                builder.CreateBr(next_block_a);
+                                builder.SetInsertPoint(next_block_a);
+
+                                if (virtual_stack.top_is(kind))
+                                {
+                                    builder.CreateStore(virtual_stack.pop().value, variable);
+                                }
+                                else if (   virtual_stack.empty()
+                                         && (parameter != word_types.parameters.end())
+                                         && (parameter->second.write_index == i))
+                                {
+                                    auto value = generate_pop_unchecked(builder,
+                                                                        runtime_api,
+                                                                        get_scalar_type(builder,
+                                                                                        kind));
+                                    builder.CreateStore(value, variable);
+                                }
+                                else
+                                {
+                                    // The inference was wrong, this variable will need to be
+                                    // boxed.
+                                    boxed_variables.insert(name);
+                                }
+
+                                builder.CreateBr(next_block_b);
+                                builder.SetInsertPoint(next_block_b);
+
+                                builder.CreateBr(next_block_c);
+                                builder.SetInsertPoint(next_block_c);
+                                break;
+                            }
+
+                            // If we know which of our variables is being written we can update it
+                            // directly.
+                            if (virtual_stack.top_is(VirtualStack::Kind::variable))
+                            {
+                                auto variable = virtual_stack.pop().value;
+
+                                builder.CreateBr(next_block_a);
+                                builder.SetInsertPoint(next_block_a);
+
+                                if (virtual_stack.top_is(VirtualStack::Kind::value))
+                                {
+                                    auto variable_temp = virtual_stack.pop().value;
+
+                                    generate_copy_value(builder,
+                                                        runtime_api,
+                                                        variable_temp,
+                                                        variable,
+                                                        true);
+                                }
+                                else if (virtual_stack.top_is_scalar())
+                                {
+                                    // Release whatever the variable was holding before, then
+                                    // write the new scalar in place.
+                                    builder.CreateCall(runtime_api.free_variable, { variable });
+                                    generate_entry_to_value(builder,
+                                                            runtime_api,
+                                                            virtual_stack.pop(),
+                                                            variable);
+                                }
+                                else
+                                {
+                                    // Pop straight into the variable, the pop leaves it untouched
+                                    // on underflow.
+                                    virtual_stack.generate_spill(builder, runtime_api);
+
+                                    auto pop_result = builder.CreateCall(runtime_api.stack_pop,
+                                                                         { variable });
+
+                                    auto cmp = builder.CreateICmpNE(pop_result,
+                                                                    builder.getInt1(0));
+                                    generate_error_branch(cmp, next_block_b);
+                                }
+
+                                if (builder.GetInsertBlock() != next_block_b)
+                                {
+                                    builder.CreateBr(next_block_b);
+                                    builder.SetInsertPoint(next_block_b);
+                                }
+
+                                builder.CreateBr(next_block_c);
+                                builder.SetInsertPoint(next_block_c);
+                                break;
+                            }
+
+                            auto index = generate_pop_index(next_block_a);
+
+                            llvm::Value* variable_temp = nullptr;
+
+                            if (virtual_stack.top_is(VirtualStack::Kind::value))
+                            {
+                                variable_temp = virtual_stack.pop().value;
+
+                                builder.CreateBr(next_block_b);
+                                builder.SetInsertPoint(next_block_b);
+                            }
+                            else if (virtual_stack.top_is_scalar())
+                            {
+                                variable_temp = create_entry_alloca(builder,
+                                                                  runtime_api.value_struct_type);
+                                builder.CreateCall(runtime_api.initialize_variable,
+                                                   { variable_temp });
+
+                                generate_entry_to_value(builder,
+                                                        runtime_api,
+                                                        virtual_stack.pop(),
+                                                        variable_temp);
+
+                                builder.CreateBr(next_block_b);
+                                builder.SetInsertPoint(next_block_b);
+                            }
+                            else
+                            {
+                                variable_temp = create_entry_alloca(builder,
+                                                                  runtime_api.value_struct_type);
+
+                                auto pop_result = builder.CreateCall(runtime_api.stack_pop_move,
+                                                                     { variable_temp });
+
+                                auto cmp = builder.CreateICmpNE(pop_result, builder.getInt1(0));
+                                generate_error_branch(cmp, next_block_b);
+                            }
+
+                            // The temporary isn't used again so it's value is moved into the
+                            // variable.  It's only left holding anything if the write failed.
+                            auto write_result = builder.CreateCall(runtime_api.replace_variable,
+                                                                   { index, variable_temp });
+                            builder.CreateCall(runtime_api.free_variable, { variable_temp });
+
+                            auto cmp = builder.CreateICmpNE(write_result, builder.getInt1(0));
+                            generate_error_branch(cmp, next_block_c);
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::execute:
+                        {
+                            auto& value = instruction.get_value();
+
+                            if (value.is_string())
+                            {
+                                auto name = value.get_string();
+
+                                auto var_iter = variable_map.find(name);
+                                auto const_iter = constant_map.find(name);
+                                auto global_iter = global_constant_map.find(name);
+
+                                if (   (var_iter != variable_map.end())
+                                    && (var_iter->second.unboxed_variable != nullptr))
+                                {
+                                    virtual_stack.push(VirtualStack::Kind::typed_variable,
+                                                       var_iter->second.unboxed_variable);
+                                }
+                                else if (var_iter != variable_map.end())
+                                {
+                                    // Keep track of the variable itself, it's index will only be
+                                    // needed if it's written to the run-time stack.
+                                    virtual_stack.push_variable(var_iter->second.variable,
+                                                                var_iter->second.variable_index);
+                                }
+                                else if (const_iter != constant_map.end())
+                                {
+                                    auto variable_temp =
+                                                create_entry_alloca(builder,
+                                                                    runtime_api.value_struct_type);
+                                    builder.CreateCall(runtime_api.initialize_variable,
+                                                       { variable_temp });
+
+                                    builder.CreateCall(runtime_api.deep_copy_variable,
+                                                       { const_iter->second, variable_temp });
+
+                                    virtual_stack.push(VirtualStack::Kind::value, variable_temp);
+                                }
+                                else if (global_iter != global_constant_map.end())
+                                {
+                                    auto variable_temp =
+                                                create_entry_alloca(builder,
+                                                                    runtime_api.value_struct_type);
+                                    builder.CreateCall(runtime_api.initialize_variable,
+                                                       { variable_temp });
+
+                                    builder.CreateCall(runtime_api.deep_copy_variable,
+                                                       { global_iter->second, variable_temp });
+
+                                    virtual_stack.push(VirtualStack::Kind::value, variable_temp);
+                                }
+                                else
+                                {
+                                    throw_error("Word " + name + " not found for execution, " +
+                                                "referenced by " + word_name + ".");
+                                }
+
+                                builder.CreateBr(blocks[i]);
+                                builder.SetInsertPoint(blocks[i]);
+                            }
+                            else if (value.is_numeric())
+                            {
+                                auto index = value.get_int();
+
+                                if (   (index < 0)
+                                    || (index >= collection.words.size()))
+                                {
+                                    throw_error("Word index " + std::to_string(index) +
+                                                " out of range.");
+                                }
+
+                                index = resolve_execute_target(index);
+
+                                const auto& word = collection.words[index];
+
+                                if (   is_execute_word(index)
+                                    && generate_execute_inline_cache(word.function, blocks[i]))
+                                {
+                                    break;
+                                }
+
+                                // The native stack words can often be performed at compile time
+                                // on the values we're already tracking.
+                                if (   std::holds_alternative<NoExtraInfo>(word.extra_info)
+                                    && virtual_stack.generate_stack_word(builder,
+                                                                         runtime_api,
+                                                                         word.handler_name))
+                                {
+                                    builder.CreateBr(blocks[i]);
+                                    builder.SetInsertPoint(blocks[i]);
+                                    break;
+                                }
+
+                                // Arithmetic and comparisons on numbers are done inline.
+                                auto numeric_iter = collection.numeric_words.find(index);
+
+                                if (   (numeric_iter != collection.numeric_words.end())
+                                    && generate_numeric_word(numeric_iter->second,
+                                                             word.function,
+                                                             blocks[i]))
+                                {
+                                    break;
+                                }
+
+                                // If we know the types of the values a Forth word starts with,
+                                // call a version of the word specialized for them.
+                                auto word_function = word.function;
+
+                                if (std::holds_alternative<byte_code::ByteCode>(word.extra_info))
+                                {
+                                    auto& counts = collection.input_counts;
+
+                                    if (counts.find(index) == counts.end())
+                                    {
+                                        const auto& word_code =
+                                                std::get<byte_code::ByteCode>(word.extra_info);
+
+                                        counts[index] = count_word_inputs(collection, word_code);
+                                    }
+
+                                    auto inputs = virtual_stack.top_scalar_kinds(counts[index]);
+
+                                    if (!inputs.empty())
+                                    {
+                                        word_function = get_word_specialization(collection,
+                                                                                module,
+                                                                                index,
+                                                                                inputs);
+                                    }
+                                }
+
+                                // The word will want to see everything we've pushed so far.
+                                virtual_stack.generate_spill(builder, runtime_api);
+
+                                auto result = builder.CreateCall(word_function, {});
+
+                                if (   !is_top_level
+                                    && catch_markers.empty()
+                                    && std::holds_alternative<byte_code::ByteCode>(word.extra_info)
+                                    && is_tail_position(i))
+                                {
+                                    tail_calls.push_back(result);
+                                }
+
+                                // Check the result of the call instruction and branch to the next
+                                // if no errors were raised, otherwise branch to the either the
+                                // exit block or the exception handler block.
+                                auto cmp = builder.CreateICmpNE(result, builder.getInt1(0));
+                                generate_error_branch(cmp, blocks[i]);
+                            }
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::word_index:
+                        {
+                            auto word_name = instruction.get_value().get_string();
+                            auto exists = collection.word_map.find(word_name);
+
+                            if (exists == collection.word_map.end())
+                            {
+                                throw_error("Word " + word_name + " not found for indexing.");
+                            }
+
+                            auto word_info = collection.words[exists->second];
+
+                            auto index = exists->second;
+                            auto index_const = builder.getInt64(index);
+
+                            virtual_stack.push(VirtualStack::Kind::int_value, index_const);
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::word_exists:
+                        {
+                            auto exists = collection.word_map
+                                                    .find(instruction.get_value().get_string())
+                                                    != collection.word_map.end();
+
+                            auto exists_const = llvm::ConstantInt::get(bool_type, exists);
+                            virtual_stack.push(VirtualStack::Kind::bool_value, exists_const);
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::push_constant_value:
+                        {
+                            // Get the value to push from the instruction.
+                            auto& value = code[i].get_value();
+
+                            // Check the type of the value.  If it's one of the simple types
+                            // we can keep it in the virtual stack as a constant.
+                            if (value.is_bool())
+                            {
+                                auto bool_value = value.get_bool();
+                                auto bool_const = llvm::ConstantInt::get(bool_type, bool_value);
+                                virtual_stack.push(VirtualStack::Kind::bool_value, bool_const);
+                            }
+                            else if (value.is_int())
+                            {
+                                auto int_value = value.get_int();
+                                auto int_const = llvm::ConstantInt::get(int64_type, int_value);
+                                virtual_stack.push(VirtualStack::Kind::int_value, int_const);
+                            }
+                            else if (value.is_double())
+                            {
+                                auto double_value = value.get_double();
+                                auto double_const = llvm::ConstantFP::get(double_type,
+                                                                            double_value);
+                                virtual_stack.push(VirtualStack::Kind::double_value,
+                                                   double_const);
+                            }
+                            else if (value.is_string())
+                            {
+                                auto string_value = value.get_string();
+                                auto string_ptr = define_string_constant(string_value,
+                                                                            builder,
+                                                                            module,
+                                                                            context);
+                                virtual_stack.generate_spill(builder, runtime_api);
+                                builder.CreateCall(runtime_api.stack_push_string,
+                                                    { string_ptr });
+                            }
+                            else
+                            {
+                                throw_error("TODO: Implement complex constant types.");
+                            }
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::mark_loop_exit:
+                        {
+                            // Capture the start and end indexes of the loop for later use.
+                            auto start_index = i + 1;
+                            auto end_index = i + code[i].get_value().get_int();
+
+                            loop_markers.push_back({ start_index, end_index });
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::unmark_loop_exit:
+                        {
+                            // Clear the current loop markers.
+                            loop_markers.pop_back();
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::mark_catch:
+                        {
+                            // Capture the index of the catch block for later use.
+                            auto target_index = i + code[i].get_value().get_int();
+
+                            catch_markers.push_back(target_index);
+                            catch_target_markers.insert(target_index);
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::unmark_catch:
+                        {
+                            // Clear the current catch markers so that we don't jump to then.
+                            // Note that we leave the catch_target_markers set alone so that we
+                            // can generate the code to push the exception onto the stack when
+                            // we reach the catch target instruction.
+                            catch_markers.pop_back();
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::mark_context:
+                        // TODO: Implement this.
+                        break;
+
+                    case byte_code::Instruction::Id::release_context:
+                        // TODO: Implement this.
+                        break;
+
+                    case byte_code::Instruction::Id::jump:
+                        {
+                            // Jump to the target block.
+                            auto index = i + code[i].get_value().get_int();
+
+                            virtual_stack.generate_spill(builder, runtime_api);
+                            builder.CreateBr(blocks[index]);
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::jump_if_zero:
+                        {
+                            // Convert the relative index to an absolute index.
+                            auto index = i + code[i].get_value().get_int();
+
+                            auto [ a, b ] = auto_jump_blocks[i];
+
+                            // Get the test value from the stack.  If the pop fails we'll branch to
+                            // either the exit block or the exception handler block.
+                            auto test_value = generate_pop_test(a);
+
+                            // The target blocks expect to find everything on the run-time stack.
+                            virtual_stack.generate_spill(builder, runtime_api);
+
+                            // Jump to the 'success' block if the test value is true, otherwise
+                            // jump to the 'fail' block.
+                            builder.CreateCondBr(test_value, b, blocks[index]);
+                            builder.SetInsertPoint(b);
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::jump_if_not_zero:
+                        {
+                            // Convert the relative index to an absolute index.
+                            auto index = i + code[i].get_value().get_int();
+
+                            auto [ a, b ] = auto_jump_blocks[i];
+
+                            // Get the test value from the stack.  If the pop fails we'll branch to
+                            // either the exit block or the exception handler block.
+                            auto test_value = generate_pop_test(a);
+
+                            // The target blocks expect to find everything on the run-time stack.
+                            virtual_stack.generate_spill(builder, runtime_api);
+
+                            // Jump to the 'success' block if the test value is true, otherwise
+                            // jump to the 'fail' block.
+                            builder.CreateCondBr(test_value, blocks[index], b);
+                            builder.SetInsertPoint(b);
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::jump_loop_start:
+                        {
+                            // Jump to the start block of the loop.
+                            auto start_index = loop_markers.back().first;
+
+                            virtual_stack.generate_spill(builder, runtime_api);
+                            builder.CreateBr(blocks[start_index]);
+                            builder.SetInsertPoint(blocks[i]);
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::jump_loop_exit:
+                        {
+                            // Jump to the end block of the loop.
+                            auto end_index = loop_markers.back().second;
+
+                            virtual_stack.generate_spill(builder, runtime_api);
+                            builder.CreateBr(blocks[end_index]);
+                            builder.SetInsertPoint(blocks[i]);
+                        }
+                        break;
+
+                    case byte_code::Instruction::Id::jump_target:
+                        // Make sure that the current block has a terminator instruction, if
+                        // not, add one to jump to the next block.  This is because this
+                        // would be a natural follow through in the original byte-code.
+                        if (builder.GetInsertBlock()->getTerminator() == nullptr)
+                        {
+                            virtual_stack.generate_spill(builder, runtime_api);
+                            builder.CreateBr(blocks[i]);
+                        }
+
+                        // We're done with the current block, switch over to the next.
+                        builder.SetInsertPoint(blocks[i]);
+
+
+                        // If this is a catch target, we need to generate the code to push
+                        // the exception onto the stack and clear the last exception.
+                        if (   (!catch_target_markers.empty())
+                            && (catch_target_markers.find(i) != catch_target_markers.end()))
+                        {
+                            auto last_error = builder.CreateCall(runtime_api.get_last_error, {});
+
+                            builder.CreateCall(runtime_api.stack_push_string, { last_error });
+                            builder.CreateCall(runtime_api.clear_last_error, {});
+                        }
+                        break;
+                }
+            }
+
+            // Anything left over belongs on the run-time stack for our caller.
+            if (builder.GetInsertBlock()->getTerminator() == nullptr)
+            {
+                virtual_stack.generate_spill(builder, runtime_api);
+            }
+
+            // Now that we know how the variables were used, register them with the run-time if any
+            // of their indices could have been seen outside of this word.  Otherwise all accesses
+            // have been made directly to the variables themselves.
+            bool register_variables = virtual_stack.has_escaped_variables();
+
+            if (register_variables)
+            {
+                // This is done at the start of the word's code rather than in the entry block so
+                // that the registration is skipped if the generic version of the word is run
+                // instead.
+                auto current_block = builder.GetInsertBlock();
+                builder.SetInsertPoint(code_block, code_block->getFirstInsertionPt());
+
+                auto value_array_type = llvm::ArrayType::get(runtime_api.value_struct_ptr_type,
+                                                             variable_map.size());
+                auto block_array = create_entry_alloca(builder, value_array_type);
+
+                for (const auto& [_, variable] : variable_map)
+                {
+                    auto array_ptr = builder.CreateStructGEP(value_array_type,
+                                                             block_array,
+                                                             variable.block_index);
+
+                    // Unboxed variables have no index, so their slots are left empty.
+                    llvm::Value* variable_ptr = variable.variable != nullptr
+                                    ? static_cast<llvm::Value*>(variable.variable)
+                                    : llvm::Constant::getNullValue(runtime_api.value_struct_ptr_type);
+
+                    builder.CreateStore(variable_ptr, array_ptr);
+                }
+
+                auto array_ptr = builder.CreateStructGEP(value_array_type, block_array, 0);
+                auto base_index = builder.CreateCall(runtime_api.allocate_variable_block,
+                                                     {
+                                                        array_ptr,
+                                                        builder.getInt64(variable_map.size())
+                                                     });
+
+                for (const auto& [_, variable] : variable_map)
+                {
+                    if (variable.variable_index == nullptr)
+                    {
+                        continue;
+                    }
+
+                    auto block_index = builder.getInt64(variable.block_index);
+                    auto new_index = builder.CreateAdd(base_index, block_index);
+
+                    builder.CreateStore(new_index, variable.variable_index);
+                }
+
+                builder.SetInsertPoint(current_block);
+            }
+
+
+            // Make sure that the last block has a terminator instruction, if not, add one to
+            // jump to the exit block.
+            if (builder.GetInsertBlock()->getTerminator() == nullptr)
+            {
+                builder.CreateBr(exit_block);
+            }
+
+            // If an error occurs set the return value to true.
+            builder.SetInsertPoint(exit_error_block);
+            builder.CreateStore(builder.getInt1(1), return_value_variable);
+            builder.CreateBr(exit_block);
+
+
+            // Make sure that all the auto-jump blocks have a terminator instruction.
+            for (auto block : blocks)
+            {
+                if (block.second->getTerminator() == nullptr)
+                {
+                    builder.SetInsertPoint(block.second);
+                    builder.CreateBr(exit_block);
+                }
+            }
+
+            // We're done with the last user code block, so switch over to the exit block and
+            // generate the code to return from the function.
+            builder.SetInsertPoint(exit_block);
+
+            // Generate the code to free all of the word's variables and constants before it
+            // returns.
+            auto generate_cleanup = [&]()
+                {
+                    // Check to see if we needed to allocated a block of variables...
+                    if (register_variables)
+                    {
+                        // Release the variable block from the runtime.
+                        builder.CreateCall(runtime_api.release_variable_block, {});
+                    }
+
+                    // First off, free all local variables and constants.
+                    for (auto iterator = variable_map.begin();
+                         iterator != variable_map.end();
+                         ++iterator)
+                    {
+                        if (iterator->second.variable != nullptr)
+                        {
+                            builder.CreateCall(runtime_api.free_variable,
+                                               { iterator->second.variable });
+                        }
+                    }
+
+                    if (is_top_level)
+                    {
+                        for (auto iterator = global_constant_map.begin();
+                             iterator != global_constant_map.end();
+                             ++iterator)
+                        {
+                            builder.CreateCall(runtime_api.free_variable, { iterator->second });
+                        }
+                    }
+                    else
+                    {
+                        for (auto iterator = constant_map.begin();
+                             iterator != constant_map.end();
+                             ++iterator)
+                        {
+                            builder.CreateCall(runtime_api.free_variable, { iterator->second });
+                        }
+                    }
+                };
+
+            generate_cleanup();
+
+            // Return and pass the return value.
+            auto return_value = builder.CreateLoad(bool_type, return_value_variable);
+            builder.CreateRet(return_value);
+
+            // A call made as the last thing the word does doesn't need this word's frame anymore.
+            // So clean up first and jump straight to the called word, returning it's result as our
+            // own.  Recursive words then run in constant stack space.  This can't be done if one
+            // of our variables' indices may have been seen by the called word.
+            if (!register_variables)
+            {
+                for (auto call : tail_calls)
+                {
+                    auto call_block = call->getParent();
+
+                    // Remove the error check that follows the call.
+                    while (&call_block->back() != call)
+                    {
+                        call_block->back().eraseFromParent();
+                    }
+
+                    builder.SetInsertPoint(call);
+                    generate_cleanup();
+
+                    call->setTailCallKind(llvm::CallInst::TCK_MustTail);
+
+                    builder.SetInsertPoint(call_block);
+                    builder.CreateRet(call);
+                }
+            }
+
+            // If any of the unboxed variables couldn't be handled, throw away what we've generated
+            // so that the word can be generated again.
+            for (auto variable : virtual_stack.get_escaped_typed_variables())
+            {
+                boxed_variables.insert(unboxed_names[variable]);
+            }
+
+            if (!boxed_variables.empty())
+            {
+                auto linkage = function->getLinkage();
+
+                function->deleteBody();
+                function->setLinkage(linkage);
+            }
+
+            return boxed_variables;
+        }
+
+
+        // Generate the IR that translates values from the data-stack to parameters for the foreign
+        // function call.  Then translate the return value from the foreign function to a value that
+        // can be pushed back onto the data-stack.
+        void generate_ir_for_ffi_function(WordCollection& collection,
+                                          const WordInfo& word,
+                                          std::shared_ptr<llvm::Module>& module,
+                                          llvm::LLVMContext& context,
+                                          llvm::IRBuilder<>& builder,
+                                          const RuntimeApi& runtime_api)
+        {
+            auto generate_block = [&context, &word]()
+                {
+                    static size_t next_block_index = 0;
+                    std::string name = "block_" + std::to_string(next_block_index);
+
+                    auto block = llvm::BasicBlock::Create(context, name, word.function);
+                    ++next_block_index;
+
+                    return block;
+                };
+
+            auto& word_ffi_info = std::get<FfiFunctionInfo>(word.extra_info);
+
+            // Create the entry point for the wrapper function.
+            auto entry_block = llvm::BasicBlock::Create(context, "entry_block", word.function);
+            builder.SetInsertPoint(entry_block);
+
+            // Generate the return value variable and it's initial value.
+            auto bool_type = llvm::Type::getInt1Ty(context);
+            auto return_variable = builder.CreateAlloca(bool_type, nullptr, "return_variable");
+            builder.CreateStore(builder.getInt1(0), return_variable);
+
+            // Get the count of parameters for the foreign function call.
+            const size_t parameter_count = word_ffi_info.parameters.size();
+
+            // Generate the block to handle errors and the final exit block that returns the error
+            // status back to the caller.
+            auto exit_error_block = llvm::BasicBlock::Create(context, "error_block", word.function);
+            auto exit_block = llvm::BasicBlock::Create(context, "exit_block", word.function);
+
+            // In the error block, we set the return value to 1 indicating failure.
+            builder.SetInsertPoint(exit_error_block);
+            builder.CreateStore(builder.getInt1(1), return_variable);
+            builder.CreateBr(exit_block);
+
+            // In the exit block, we return the value of the return variable, whatever it may be.
+            builder.SetInsertPoint(exit_block);
+            auto return_value = builder.CreateLoad(bool_type, return_variable);
+            builder.CreateRet(return_value);
+
+            // Now generate the IR for poping the values off of the data stack and translate them
+            // into the native types for the foreign function call.
+            builder.SetInsertPoint(entry_block);
+
+            // Allocate a variable for each parameter.
+            std::vector<llvm::AllocaInst*> parameter_variables;
+            parameter_variables.reserve(parameter_count);
+
+            for (size_t i = 0; i < parameter_count; ++i)
+            {
+                auto& ffi_parameter = word_ffi_info.parameters[i];
+                auto parameter_variable = builder.CreateAlloca(ffi_parameter.type.type,
+                                                               nullptr,
+                                                               "ffi_parameter");
+
+                if (ffi_parameter.type.alignment != -1)
+                {
+                    parameter_variable->setAlignment(llvm::Align(ffi_parameter.type.alignment));
+                }
+
+                parameter_variables.push_back(parameter_variable);
+            }
+
+            // Generate the code to translate an pop the values off of the stack.  We'll need to
+            // pop the parameters in reverse order.
+            for (ssize_t i = parameter_count - 1; i >= 0; --i)
+            {
+                auto& ffi_parameter = word_ffi_info.parameters[i];
+                auto& parameter_variable = parameter_variables[i];
+
+
+                // Call the type handler to generate the code to pop the value off of the stack and
+                // translate it into the native type.
+                auto param_direction = ffi_parameter.type.direction;
+
+                // If the parameter is an input or in/out parameter, we need to pop the value off
+                // of the stack, otherwise we don't actually generate any code to pop the value.
+                llvm::Value* pop_result = nullptr;
+
+                if (param_direction != PassDirection::out)
+                {
+                    pop_result = ffi_parameter.type.pop_value(builder,
+                                                              runtime_api,
+                                                              parameter_variable);
+                }
+
+                // Now we need to generate the code to check to see if the pop was successful.
+                if (pop_result != nullptr)
+                {
+                    auto comparison_result = builder.CreateICmpNE(pop_result, builder.getInt1(0));
+                    auto next_block = generate_block();
+
+                    // If the pop was successful, we can move on to the next parameter.  Otherwise
+                    // we need to jump to the error block.
+                    create_unlikely_branch(builder,
+                                           comparison_result,
+                                           exit_error_block,
+                                           next_block);
+
+                    // We are done with the current block, so move on to the next one.
+                    builder.SetInsertPoint(next_block);
+                }
+            }
+
+            // Now that all of our parameter variables have been populated, we can call the foreign
+            // function.  We need to load their values from those variables and pass them to the
+            // actual function call.
+            std::vector<llvm::Value*> loaded_parameters;
+
+            loaded_parameters.reserve(parameter_count);
+
+            // First generate the loads.
+            for (size_t i = 0; i < parameter_count; ++i)
+            {
+                auto& ffi_parameter = word_ffi_info.parameters[i];
+                llvm::Value* loaded_parameter = nullptr;
+
+                // Check to see if we're passing this parameter by value or by pointer.
+                if (ffi_parameter.type.passed_by == PassByType::value)
+                {
+                    // We're passing by value, so we need to load the value from the variable
+                    // directly.
+                    loaded_parameter = builder.CreateLoad(ffi_parameter.type.type,
+                                                          parameter_variables[i]);
+                }
+                else if (ffi_parameter.type.passed_by == PassByType::pointer)
+                {
+                    // We're passing by pointer, so take a pointer to the variable instead.
+                    loaded_parameter = builder.CreateStructGEP(ffi_parameter.type.type,
+                                                               parameter_variables[i],
+                                                               0);
+                }
+                else
+                {
+                    // We don't know how to pass this parameter type.
+                    throw_error("Internal error, unknown pass-by type for parameter " +
+                                std::to_string(i) + " for " + word.name + ".");
+                }
+
+                // Store the loaded parameter for in our parameter list.
+                loaded_parameters.push_back(loaded_parameter);
+            }
+
+            // We've loaded all the parameters now we need to allocate space for the return value.
+            auto return_value_variable = builder.CreateAlloca(word_ffi_info.return_type.type,
+                                                              nullptr,
+                                                              "ffi_return_variable");
+
+            if (word_ffi_info.return_type.alignment != -1)
+            {
+                return_value_variable->
+                                     setAlignment(llvm::Align(word_ffi_info.return_type.alignment));
+            }
+
+            // Finally we can call the function.
+            auto call_result = builder.CreateCall(word_ffi_info.function,
+                                                  loaded_parameters);
+            builder.CreateStore(call_result, return_value_variable);
+
+            // Generate pushes for all out parameters.
+            for (size_t i = 0; i < parameter_count; ++i)
+            {
+                auto& ffi_parameter = word_ffi_info.parameters[i];
+                auto direction = ffi_parameter.type.direction;
+
+                if (   (direction == PassDirection::out)
+                    || (direction == PassDirection::in_out))
+                {
+                    auto push_result = ffi_parameter.type.push_value(builder,
+                                                                     runtime_api,
+                                                                     parameter_variables[i]);
+
+                    if (push_result != nullptr)
+                    {
+                        auto comparison_result = builder.CreateICmpNE(push_result,
+                                                                      builder.getInt1(0));
+
+                        // If the push was successful, we can move on to the next parameter.
+                        // Otherwise we need to jump to the error block.
+                        auto next_block = generate_block();
+
+                        create_unlikely_branch(builder,
+                                               comparison_result,
+                                               exit_error_block,
+                                               next_block);
+
+                        // We are done with the current block, so move on to the next one.
+                        builder.SetInsertPoint(next_block);
+                    }
+                }
+            }
+
+            // Generate the push for the return value.
+            word_ffi_info.return_type.push_value(builder,
+                                                  runtime_api,
+                                                  return_value_variable);
+
+            // Now that we're done here we can jump to the exit block.
+            builder.CreateBr(exit_block);
+        }
+
+
+        void generate_ir_for_ffi_accessor(WordCollection& collection,
+                                          const WordInfo& word,
+                                          std::shared_ptr<llvm::Module>& module,
+                                          llvm::LLVMContext& context,
+                                          llvm::IRBuilder<>& builder,
+                                          const RuntimeApi& runtime_api)
+        {
+            auto bool_type = llvm::Type::getInt1Ty(context);
+            auto& word_ffi_info = std::get<FfiVariableInfo>(word.extra_info);
+
+            // Create the entry point for the wrapper function.
+            auto entry_block = llvm::BasicBlock::Create(context, "entry_block", word.function);
+            builder.SetInsertPoint(entry_block);
+            auto return_variable = builder.CreateAlloca(bool_type,
+                                                        nullptr,
+                                                        "return_variable");
+            builder.CreateStore(builder.getInt1(0), return_variable);
+
+            // Create the exit and error blocks.
+            auto error_block = llvm::BasicBlock::Create(context, "error_block", word.function);
+            auto exit_block = llvm::BasicBlock::Create(context, "exit_block", word.function);
+
+            // Generate the code to report errors.
+            builder.SetInsertPoint(error_block);
+            builder.CreateStore(builder.getInt1(1), return_variable);
+            builder.CreateBr(exit_block);
+
+            // Generate the code to return the result.
+            builder.SetInsertPoint(exit_block);
+            auto return_value = builder.CreateLoad(bool_type, return_variable);
+            builder.CreateRet(return_value);
+
+            // Generate the code to read or write the variable.
+            builder.SetInsertPoint(entry_block);
+
+            llvm::Value* handler_result = nullptr;
+
+            if (word_ffi_info.handler_type == FfiVariableHandler::reader)
+            {
+                // We're reading, so we need to generate the code to read the value from the global
+                // and push it onto the stack.
+                handler_result = word_ffi_info.type.push_value(builder,
+                                                               runtime_api,
+                                                               word_ffi_info.global);
+            }
+            else
+            {
+                // We're writing, so we need to generate the code to pop the value from the stack
+                // and write it to the global.
+                handler_result = word_ffi_info.type.pop_value(builder,
+                                                              runtime_api,
+                                                              word_ffi_info.global);
+            }
+
+            // See if we need to generate the code to check for errors.
+            if (handler_result != nullptr)
+            {
+                auto cmp = builder.CreateICmpNE(handler_result, builder.getInt1(0));
+                auto check_block = llvm::BasicBlock::Create(context,
+                                                            "check_block",
+                                                            word.function);
+
+                create_unlikely_branch(builder, cmp, error_block, check_block);
+                builder.SetInsertPoint(check_block);
+            }
+
+            // We're done here, so jump to the exit block.
+            builder.CreateBr(exit_block);
+        }
+
+
+        // Generate the body of a Forth word.  If the word's variables can be typed they're kept
+        // unboxed, and if that relies on the types of the word's parameters a generic version of
+        // the word is also generated for when they don't match.
+        //
+        // The body is generated into function, which is either the word's own function or a
+        // version of the word specialized for the given input types.  Specialized versions fall
+        // back to the word's own function if their parameters don't match.
+        void generate_ir_for_word(WordCollection& collection,
+                                  const WordInfo& word,
+                                  llvm::Function* function,
+                                  const std::vector<VirtualStack::Kind>& inputs,
+                                  std::shared_ptr<llvm::Module>& module,
+                                  llvm::LLVMContext& context,
+                                  llvm::IRBuilder<>& builder,
+                                  const RuntimeApi& runtime_api,
+                                  GlobalMap& global_constant_map)
+        {
+            const auto& code = std::get<byte_code::ByteCode>(word.extra_info);
+            auto word_types = infer_word_types(collection, code, inputs);
+            bool is_specialized = function != word.function;
+
+            if (!word_types.parameters.empty())
+            {
+                word_types.generic_function = is_specialized
+                                              ? word.function
+                                              : llvm::Function::Create(
+                                                            word.function->getFunctionType(),
+                                                            llvm::Function::InternalLinkage,
+                                                            word.handler_name + ".generic",
+                                                            module.get());
+            }
+
+            // Keep trying until the code generator is happy with the variables we've typed.  Each
+            // time around at least one more variable is boxed, so eventually we'll end up with the
+            // fully generic version of the word.
+            while (true)
+            {
+                auto boxed_variables = generate_ir_for_byte_code(collection,
+                                                                 word.name,
+                                                                 code,
+                                                                 module,
+                                                                 context,
+                                                                 builder,
+                                                                 function,
+                                                                 global_constant_map,
+                                                                 runtime_api,
+                                                                 false,
+                                                                 word_types);
+
+                if (boxed_variables.empty())
+                {
+                    break;
+                }
+
+                for (const auto& name : boxed_variables)
+                {
+                    word_types.make_boxed(name);
+                }
+            }
+
+            // Now fill in the generic version of the word, if it's still needed.
+            if ((word_types.generic_function != nullptr) && !is_specialized)
+            {
+                if (word_types.parameters.empty())
+                {
+                    word_types.generic_function->eraseFromParent();
+                }
+                else
+                {
+                    generate_ir_for_byte_code(collection,
+                                              word.name,
+                                              code,
+                                              module,
+                                              context,
+                                              builder,
+                                              word_types.generic_function,
+                                              global_constant_map,
+                                              runtime_api,
+                                              false,
+                                              WordTypes());
+                }
+            }
+        }
+
+
+        // Go through the collection of words and compile the ones that were referenced.
+        void compile_used_words(WordCollection& collection,
+                                std::shared_ptr<llvm::Module>& module,
+                                llvm::LLVMContext& context,
+                                llvm::IRBuilder<>& builder,
+                                const RuntimeApi& runtime_api,
+                                GlobalMap& global_constant_map)
+        {
+            for (const auto& word : collection.words)
+            {
+                // If the word was referenced and is a Forth word...
+                if (word.was_referenced)
+                {
+                    // Is this a Forth word?  Or is it a wrapper for a foreign function?
+                    if (std::holds_alternative<byte_code::ByteCode>(word.extra_info))
+                    {
+                        // Create the word's IR function body.
+                        generate_ir_for_word(collection,
+                                             word,
+                                             word.function,
+                                             {},
+                                             module,
+                                             context,
+                                             builder,
+                                             runtime_api,
+                                             global_constant_map);
+                    }
+                    else if (std::holds_alternative<FfiFunctionInfo>(word.extra_info))
+                    {
+                        // Create the word's wrapper code for the underlying FFI function.
+                        generate_ir_for_ffi_function(collection,
+                                                     word,
+                                                     module,
+                                                     context,
+                                                     builder,
+                                                     runtime_api);
+                    }
+                    else if (std::holds_alternative<FfiVariableInfo>(word.extra_info))
+                    {
+                        // We have a variable accessor.  So generate the code for reading or writing
+                        // to/from the global variable.
+
+                        generate_ir_for_ffi_accessor(collection,
+                                                     word,
+                                                     module,
+                                                     context,
+                                                     builder,
+                                                     runtime_api);
+                    }
+
+                    // Looks like it's a word from the run-time library.  So there's nothing to do
+                    // here.
+                }
+            }
+
+            // Now generate the specialized versions of words that were asked for by the calls in
+            // the top-level code and the words above.  They can ask for more as they go, so the
+            // list can grow while we work through it.
+            for (size_t i = 0; i < collection.specializations.size(); ++i)
+            {
+                auto specialization = collection.specializations[i];
+
+                generate_ir_for_word(collection,
+                                     collection.words[specialization.word_index],
+                                     specialization.function,
+                                     specialization.inputs,
+                                     module,
+                                     context,
+                                     builder,
+                                     runtime_api,
+                                     global_constant_map);
+            }
+        }
+
+
+        void compile_top_level_code(WordCollection& collection,
+                                    const byte_code::ByteCode& top_level_code,
+                                    std::shared_ptr<llvm::Module>& module,
+                                    llvm::LLVMContext& context,
+                                    llvm::IRBuilder<>& builder,
+                                    const RuntimeApi& runtime_api,
+                                    GlobalMap& global_constant_map)
+        {
+            // Start off by creating the signature for the top-level function.
+            llvm::FunctionType* top_level_signature =
+                                            llvm::FunctionType::get(llvm::Type::getInt1Ty(context),
+                                                                    false);
+
+            // Create the function itself.
+            llvm::Function* top_level_function =
+                                             llvm::Function::Create(top_level_signature,
+                                                                    llvm::Function::ExternalLinkage,
+                                                                    "script_top_level",
+                                                                    module.get());
+
+            generate_ir_for_byte_code(collection,
+                                      "script_top_level",
+                                      top_level_code,
+                                      module,
+                                      context,
+                                      builder,
+                                      top_level_function,
+                                      global_constant_map,
+                                      runtime_api,
+                                      true,
+                                      WordTypes());
+        }
+
+
+        // Fold the constant tests and branches left behind once some of a function's calls are
+        // known to succeed, and throw away any of its blocks that can no longer be reached.
+        void simplify_error_branches(llvm::Function* function)
+        {
+            for (auto& block : *function)
+            {
+                for (auto iterator = block.begin(); iterator != block.end(); )
+                {
+                    auto& instruction = *iterator++;
+
+                    if (!llvm::isa<llvm::CmpInst>(instruction))
+                    {
+                        continue;
+                    }
+
+                    auto constant = llvm::ConstantFoldInstruction(&instruction,
+                                                       function->getParent()->getDataLayout());
+
+                    if (constant != nullptr)
+                    {
+                        instruction.replaceAllUsesWith(constant);
+                        instruction.eraseFromParent();
+                    }
+                }
+
+                llvm::ConstantFoldTerminator(&block);
+            }
+
+            llvm::removeUnreachableBlocks(*function);
+        }
+
+
+        // Check if every way out of a word's function returns false.  The generated words keep
+        // their result in a local that's only set to true by the error block, so if that block
+        // can't be reached any more all of the stores to it will be false.
+        bool can_never_fail(llvm::Function* function)
+        {
+            auto is_false = [](llvm::Value* value)
+                {
+                    auto constant = llvm::dyn_cast<llvm::ConstantInt>(value);
+                    return (constant != nullptr) && constant->isZero();
+                };
+
+            for (auto& block : *function)
+            {
+                auto ret = llvm::dyn_cast_or_null<llvm::ReturnInst>(block.getTerminator());
+
+                if (ret == nullptr)
+                {
+                    continue;
+                }
+
+                auto value = ret->getReturnValue();
+                auto load = llvm::dyn_cast<llvm::LoadInst>(value);
+                auto variable = load != nullptr
+                                ? llvm::dyn_cast<llvm::AllocaInst>(load->getPointerOperand())
+                                : nullptr;
+
+                if (variable == nullptr)
+                {
+                    if (!is_false(value))
+                    {
+                        return false;
+                    }
+
+                    continue;
+                }
+
+                for (auto user : variable->users())
+                {
+                    if (auto store = llvm::dyn_cast<llvm::StoreInst>(user))
+                    {
+                        if (   (store->getPointerOperand() != variable)
+                            || (!is_false(store->getValueOperand())))
+                        {
+                            return false;
+                        }
+                    }
+                    else if (!llvm::isa<llvm::LoadInst>(user))
+                    {
+                        return false;
+                    }
+                }
+            }
+
+            return true;
+        }
+
+
+        // Find the Forth words that can never raise an error, either because they only do things
+        // that can't fail or because they only call other words that can't.  Their callers don't
+        // need to check for errors after calling them, and the words themselves are moved into
+        // functions that return nothing.  The original function is kept as a wrapper so that the
+        // word table still has a function with the standard signature to point at.
+        void remove_unneeded_error_checks(std::shared_ptr<llvm::Module>& module)
+        {
+            auto& context = module->getContext();
+            auto false_value = llvm::ConstantInt::getFalse(context);
+
+            auto is_word_function = [](const llvm::Function& function)
+                {
+                    return    (!function.isDeclaration())
+                           && function.hasLocalLinkage()
+                           && (function.arg_size() == 0)
+                           && function.getReturnType()->isIntegerTy(1);
+                };
+
+            auto direct_calls = [](llvm::Function* function)
+                {
+                    std::vector<llvm::CallInst*> calls;
+
+                    for (auto user : function->users())
+                    {
+                        auto call = llvm::dyn_cast<llvm::CallInst>(user);
+
+                        if ((call != nullptr) && (call->getCalledFunction() == function))
+                        {
+                            calls.push_back(call);
+                        }
+                    }
+
+                    return calls;
+                };
+
+            // Keep going until no new words are found, every word we find can make more of its
+            // callers safe.
+            std::vector<llvm::Function*> safe_words;
+            std::set<llvm::Function*> found;
+            bool changed = true;
+
+            while (changed)
+            {
+                changed = false;
+
+                for (auto& function : *module)
+                {
+                    if (   (!is_word_function(function))
+                        || (found.find(&function) != found.end()))
+                    {
+                        continue;
+                    }
+
+                    simplify_error_branches(&function);
+
+                    if (!can_never_fail(&function))
+                    {
+                        continue;
+                    }
+
+                    safe_words.push_back(&function);
+                    found.insert(&function);
+                    changed = true;
+
+                    std::set<llvm::Function*> callers;
+
+                    for (auto call : direct_calls(&function))
+                    {
+                        // A guaranteed tail call has to return the callee's result, which is now
+                        // always false, so it becomes a regular call.
+                        if (call->isMustTailCall())
+                        {
+                            call->setTailCallKind(llvm::CallInst::TCK_Tail);
+                        }
+
+                        call->replaceAllUsesWith(false_value);
+                        callers.insert(call->getFunction());
+                    }
+
+                    for (auto caller : callers)
+                    {
+                        simplify_error_branches(caller);
+                    }
+                }
+            }
+
+            // Now move the safe words into functions that don't return a result.
+            auto void_signature = llvm::FunctionType::get(llvm::Type::getVoidTy(context), false);
+
+            for (auto function : safe_words)
+            {
+                auto body = llvm::Function::Create(void_signature,
+                                                   llvm::Function::InternalLinkage,
+                                                   function->getName() + ".nofail",
+                                                   module.get());
+
+                body->splice(body->begin(), function);
+
+                for (auto& block : *body)
+                {
+                    if (auto ret = llvm::dyn_cast<llvm::ReturnInst>(block.getTerminator()))
+                    {
+                        llvm::ReturnInst::Create(context, nullptr, ret);
+                        ret->eraseFromParent();
+                    }
+                }
+
+                for (auto call : direct_calls(function))
+                {
+                    auto new_call = llvm::CallInst::Create(void_signature, body, "", call);
+
+                    new_call->setTailCallKind(call->getTailCallKind());
+                    call->eraseFromParent();
+                }
+
+                llvm::IRBuilder<> builder(llvm::BasicBlock::Create(context, "entry", function));
+
+                builder.CreateCall(body, {});
+                builder.CreateRet(false_value);
+            }
+        }
+
+
+        // Create the word table for the runtime.
+        void create_word_table(const WordCollection& collection,
+                               std::shared_ptr<llvm::Module>& module,
+                               llvm::LLVMContext& context)
+        {
+            auto function_type = llvm::FunctionType::get(llvm::Type::getInt1Ty(context), false);
+            auto function_ptr_type = llvm::PointerType::getUnqual(function_type);
+            auto table_size = collection.words.size();
+
+            auto word_table_type = llvm::ArrayType::get(function_ptr_type, table_size);
+            std::vector<llvm::Constant*> word_table_values;
+
+            for (size_t i = 0; i < table_size; ++i)
+            {
+                auto& word = collection.words[i];
+
+                if (word.was_referenced)
+                {
+                    word_table_values.push_back(word.function);
+                }
+                else
+                {
+                    word_table_values.push_back(llvm::Constant::getNullValue(function_ptr_type));
+                }
+            }
+
+            auto word_table_constant = llvm::ConstantArray::get(word_table_type, word_table_values);
+
+            auto word_table = new llvm::GlobalVariable(*module,
+                                                       word_table_type,
+                                                       true,
+                                                       llvm::GlobalValue::ExternalLinkage,
+                                                       word_table_constant,
+                                                       "word_table");
+        }
+
+
+        // A generated function along with it's conditional branches, in the order that they
+        // appear in the function.
+        struct ProfiledFunction
+        {
+            llvm::Function* function;
+            std::vector<llvm::BranchInst*> branches;
+        };
+
+
+        // Gather the functions that we generated along with their branches.  Collecting a profile
+        // and applying one both walk the code the same way, so that the counters in the profile
+        // line up with the branches that they counted.  This only works as long as the program is
+        // compiled from the same source with the same options both times.
+        std::vector<ProfiledFunction> gather_profiled_functions(llvm::Module& module)
+        {
+            std::vector<ProfiledFunction> functions;
+
+            for (auto& function : module)
+            {
+                if (function.isDeclaration())
+                {
+                    continue;
+                }
+
+                ProfiledFunction profiled = { &function, {} };
+
+                for (auto& block : function)
+                {
+                    auto branch = llvm::dyn_cast<llvm::BranchInst>(block.getTerminator());
+
+                    if (   branch
+                        && branch->isConditional())
+                    {
+                        profiled.branches.push_back(branch);
+                    }
+                }
+
+                functions.push_back(profiled);
+            }
+
+            return functions;
+        }
+
+
+        // Check if any of the words that start or talk to threads are used by the program.
+        bool uses_threads(const WordCollection& collection)
+        {
+            for (const auto& word : collection.words)
+            {
+                if (word.was_referenced && word.name.starts_with("thread."))
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+
+        // Add a constructor that switches the run-time over to non-atomic reference counts before
+        // the program starts.  Only safe for programs that will never have more than one thread.
+        void disable_atomic_reference_counts(std::shared_ptr<llvm::Module>& module,
+                                             llvm::LLVMContext& context)
+        {
+            auto void_type = llvm::Type::getVoidTy(context);
+            auto flag = module->getOrInsertGlobal("atomic_reference_counts",
+                                                  llvm::Type::getInt8Ty(context));
+
+            auto constructor = llvm::Function::Create(llvm::FunctionType::get(void_type, false),
+                                                      llvm::GlobalValue::InternalLinkage,
+                                                      "atomic_reference_counts.constructor",
+                                                      module.get());
+
+            llvm::IRBuilder<> builder(llvm::BasicBlock::Create(context, "entry", constructor));
+
+            builder.CreateStore(builder.getInt8(0), flag);
+            builder.CreateRetVoid();
+
+            llvm::appendToGlobalCtors(*module, constructor, 0);
+        }
+
+
+        // Add counters to each of the generated functions, counting how often the function is
+        // called and which way each of it's branches go.  A constructor registers the counters
+        // with the run-time, which writes them to the profile file as the program exits.
+        void instrument_for_profiling(std::shared_ptr<llvm::Module>& module,
+                                      llvm::LLVMContext& context,
+                                      const std::filesystem::path& profile_path)
+        {
+            auto functions = gather_profiled_functions(*module);
+
+            auto void_type = llvm::Type::getVoidTy(context);
+            auto uint64_type = llvm::Type::getInt64Ty(context);
+            auto char_ptr_type = llvm::PointerType::getUnqual(llvm::Type::getInt8Ty(context));
+            auto uint64_ptr_type = llvm::PointerType::getUnqual(uint64_type);
+
+            auto descriptor_type = llvm::StructType::create(context,
+                                                            {
+                                                                char_ptr_type,
+                                                                uint64_ptr_type,
+                                                                uint64_type
+                                                            },
+                                                            "ProfileFunctionData");
+
+            auto create_string = [&](const std::string& text) -> llvm::Constant*
+                {
+                    auto string_constant = llvm::ConstantDataArray::getString(context, text, true);
+
+                    return new llvm::GlobalVariable(*module,
+                                                    string_constant->getType(),
+                                                    true,
+                                                    llvm::GlobalValue::PrivateLinkage,
+                                                    string_constant);
+                };
+
+            std::vector<llvm::Constant*> descriptors;
 
-                        // We're done with the current block, switch over to the next.
-                        builder.SetInsertPoint(blocks[i]);
+            for (const auto& profiled : functions)
+            {
+                auto counter_count = 1 + (2 * profiled.branches.size());
+                auto counters_type = llvm::ArrayType::get(uint64_type, counter_count);
+                auto zero_counters = llvm::ConstantAggregateZero::get(counters_type);
+                auto counters = new llvm::GlobalVariable(*module,
+                                                         counters_type,
+                                                         false,
+                                                         llvm::GlobalValue::InternalLinkage,
+                                                         zero_counters,
+                                                         profiled.function->getName() + ".counters");
+
+                llvm::IRBuilder<> builder(context);
+
+                auto increment_counter = [&](llvm::Value* index)
+                    {
+                        auto counter = builder.CreateGEP(counters_type,
+                                                         counters,
+                                                         { builder.getInt64(0), index });
+                        auto count = builder.CreateLoad(uint64_type, counter);
 
+                        builder.CreateStore(builder.CreateAdd(count, builder.getInt64(1)),
+                                            counter);
+                    };
 
-                        // If this is a catch target, we need to generate the code to push
-                        // the exception onto the stack and clear the last exception.
-                        if (   (!catch_target_markers.empty())
-                            && (catch_target_markers.find(i) != catch_target_markers.end()))
-                        {
-                            auto last_error = builder.CreateCall(runtime_api.get_last_error, {});
+                // Count the calls to the function.
+                builder.SetInsertPoint(&*profiled.function->getEntryBlock().getFirstInsertionPt());
+                increment_counter(builder.getInt64(0));
 
-                            builder.CreateCall(runtime_api.stack_push_string, { last_error });
-                            builder.CreateCall(runtime_api.clear_last_error, {});
-                        }
-                        break;
+                // Count which way each of the branches goes, the taken count is followed by the
+                // not taken count.
+                for (size_t i = 0; i < profiled.branches.size(); ++i)
+                {
+                    auto branch = profiled.branches[i];
+
+                    builder.SetInsertPoint(branch);
+
+                    auto index = builder.CreateSelect(branch->getCondition(),
+                                                      builder.getInt64(1 + (2 * i)),
+                                                      builder.getInt64(2 + (2 * i)));
+
+                    increment_counter(index);
                 }
+
+                descriptors.push_back(llvm::ConstantStruct::get(descriptor_type,
+                                            {
+                                                create_string(profiled.function->getName().str()),
+                                                counters,
+                                                llvm::ConstantInt::get(uint64_type, counter_count)
+                                            }));
             }
 
+            auto table_type = llvm::ArrayType::get(descriptor_type, descriptors.size());
+            auto table = new llvm::GlobalVariable(*module,
+                                                  table_type,
+                                                  true,
+                                                  llvm::GlobalValue::InternalLinkage,
+                                                  llvm::ConstantArray::get(table_type, descriptors),
+                                                  "profile_data_table");
+
+            // Register the counters with the run-time before the program starts.
+            auto register_type = llvm::FunctionType::get(void_type,
+                                                         { char_ptr_type,
+                                                           uint64_type,
+                                                           char_ptr_type },
+                                                         false);
+            auto register_function = module->getOrInsertFunction("register_profile_data",
+                                                                 register_type);
 
-            // Make sure that the last block has a terminator instruction, if not, add one to
-            // jump to the exit block.
-            if (builder.GetInsertBlock()->getTerminator() == nullptr)
-            {
-                builder.CreateBr(exit_block);
-            }
+            auto constructor = llvm::Function::Create(llvm::FunctionType::get(void_type, false),
+                                                      llvm::GlobalValue::InternalLinkage,
+                                                      "register_profile_data.constructor",
+                                                      module.get());
 
-            // If an error occurs set the return value to true.
-            builder.SetInsertPoint(exit_error_block);
-            builder.CreateStore(builder.getInt1(1), return_value_variable);
-            builder.CreateBr(exit_block);
+            llvm::IRBuilder<> builder(llvm::BasicBlock::Create(context, "entry", constructor));
 
+            builder.CreateCall(register_function,
+                               {
+                                   builder.CreatePointerCast(table, char_ptr_type),
+                                   builder.getInt64(descriptors.size()),
+                                   builder.CreatePointerCast(create_string(profile_path.string()),
+                                                             char_ptr_type)
+                               });
+            builder.CreateRetVoid();
 
-            // Make sure that all the auto-jump blocks have a terminator instruction.
-            for (auto block : blocks)
-            {
-                if (block.second->getTerminator() == nullptr)
-                {
-                    builder.SetInsertPoint(block.second);
-                    builder.CreateBr(exit_block);
-                }
-            }
+            llvm::appendToGlobalCtors(*module, constructor, 0);
+        }
 
-            // We're done with the last user code block, so switch over to the exit block and
-            // generate the code to return from the function.
-            builder.SetInsertPoint(exit_block);
 
-            // Check to see if we needed to allocated a block of variables...
-            if (!variable_map.empty())
+        // Read the profile written by a program that was built with instrument_for_profiling.
+        std::unordered_map<std::string, std::vector<uint64_t>> read_profile(
+                                                            const std::filesystem::path& path)
+        {
+            std::ifstream stream(path);
+
+            if (!stream)
             {
-                // Release the variable block from the runtime.
-                builder.CreateCall(runtime_api.release_variable_block, {});
+                throw_error("Could not open the profile file " + path.string() + ".");
             }
 
-            // First off, free all local variables and constants.
-            for (auto iterator = variable_map.begin(); iterator != variable_map.end(); ++iterator)
+            std::string magic;
+            int version = 0;
+
+            stream >> magic >> version;
+
+            if (   magic != "sorth-profile"
+                || version != 1)
             {
-                builder.CreateCall(runtime_api.free_variable, { iterator->second.variable });
+                throw_error("The file " + path.string() + " is not a Strange Forth profile.");
             }
 
-            if (is_top_level)
+            std::unordered_map<std::string, std::vector<uint64_t>> profile;
+            std::string name;
+            size_t counter_count = 0;
+
+            while (stream >> name >> counter_count)
             {
-                for (auto iterator = global_constant_map.begin();
-                     iterator != global_constant_map.end();
-                     ++iterator)
+                std::vector<uint64_t> counters(counter_count);
+
+                for (auto& counter : counters)
                 {
-                    builder.CreateCall(runtime_api.free_variable, { iterator->second });
+                    stream >> counter;
                 }
-            }
-            else
-            {
-                for (auto iterator = constant_map.begin();
-                     iterator != constant_map.end();
-                     ++iterator)
+
+                if (!stream)
                 {
-                    builder.CreateCall(runtime_api.free_variable, { iterator->second });
+                    throw_error("The profile file " + path.string() + " is truncated.");
                 }
+
+                profile[name] = std::move(counters);
             }
 
-            // Return and pass the return value.
-            auto return_value = builder.CreateLoad(bool_type, return_value_variable);
-            builder.CreateRet(return_value);
+            return profile;
         }
 
 
-        // Generate the IR that translates values from the data-stack to parameters for the foreign
-        // function call.  Then translate the return value from the foreign function to a value that
-        // can be pushed back onto the data-stack.
-        void generate_ir_for_ffi_function(WordCollection& collection,
-                                          const WordInfo& word,
-                                          std::shared_ptr<llvm::Module>& module,
-                                          llvm::LLVMContext& context,
-                                          llvm::IRBuilder<>& builder,
-                                          const RuntimeApi& runtime_api)
+        // Attach a previously collected profile to the generated code, as function entry counts
+        // and branch weights, so that the optimizer knows which code is hot and which way the
+        // branches tend to go.  Functions that have changed since the profile was collected keep
+        // the static estimates that the code was generated with.
+        void apply_profile(std::shared_ptr<llvm::Module>& module,
+                           llvm::LLVMContext& context,
+                           const std::filesystem::path& profile_path)
         {
-            auto generate_block = [&context, &word]()
-                {
-                    static size_t next_block_index = 0;
-                    std::string name = "block_" + std::to_string(next_block_index);
+            auto profile = read_profile(profile_path);
+            auto functions = gather_profiled_functions(*module);
 
-                    auto block = llvm::BasicBlock::Create(context, name, word.function);
-                    ++next_block_index;
+            llvm::MDBuilder md_builder(context);
+            llvm::InstrProfSummaryBuilder summary_builder(
+                                                llvm::ProfileSummaryBuilder::DefaultCutoffs.vec());
+            size_t mismatched = 0;
 
-                    return block;
+            // Branch weights are only 32 bits wide, so scale down any counts that don't fit.
+            auto scale_weights = [](uint64_t taken, uint64_t not_taken)
+                {
+                    uint64_t scale = (std::max(taken, not_taken) / UINT32_MAX) + 1;
+
+                    return std::make_pair(static_cast<uint32_t>(taken / scale),
+                                          static_cast<uint32_t>(not_taken / scale));
                 };
 
-            auto& word_ffi_info = std::get<FfiFunctionInfo>(word.extra_info);
+            for (const auto& profiled : functions)
+            {
+                auto iterator = profile.find(profiled.function->getName().str());
 
-            // Create the entry point for the wrapper function.
-            auto entry_block = llvm::BasicBlock::Create(context, "entry_block", word.function);
-            builder.SetInsertPoint(entry_block);
+                if (iterator == profile.end())
+                {
+                    continue;
+                }
 
-            // Generate the return value variable and it's initial value.
-            auto bool_type = llvm::Type::getInt1Ty(context);
-            auto return_variable = builder.CreateAlloca(bool_type, nullptr, "return_variable");
-            builder.CreateStore(builder.getInt1(0), return_variable);
+                const auto& counters = iterator->second;
 
-            // Get the count of parameters for the foreign function call.
-            const size_t parameter_count = word_ffi_info.parameters.size();
+                if (counters.size() != 1 + (2 * profiled.branches.size()))
+                {
+                    ++mismatched;
+                    continue;
+                }
 
-            // Generate the block to handle errors and the final exit block that returns the error
-            // status back to the caller.
-            auto exit_error_block = llvm::BasicBlock::Create(context, "error_block", word.function);
-            auto exit_block = llvm::BasicBlock::Create(context, "exit_block", word.function);
+                // Our counters are laid out the same way as LLVM's own instrumentation, the entry
+                // count followed by the counts inside of the function.
+                profiled.function->setEntryCount(counters[0]);
+                summary_builder.addRecord(llvm::InstrProfRecord(counters));
 
-            // In the error block, we set the return value to 1 indicating failure.
-            builder.SetInsertPoint(exit_error_block);
-            builder.CreateStore(builder.getInt1(1), return_variable);
-            builder.CreateBr(exit_block);
+                for (size_t i = 0; i < profiled.branches.size(); ++i)
+                {
+                    auto taken = counters[1 + (2 * i)];
+                    auto not_taken = counters[2 + (2 * i)];
 
-            // In the exit block, we return the value of the return variable, whatever it may be.
-            builder.SetInsertPoint(exit_block);
-            auto return_value = builder.CreateLoad(bool_type, return_variable);
-            builder.CreateRet(return_value);
+                    if (taken + not_taken == 0)
+                    {
+                        continue;
+                    }
 
-            // Now generate the IR for poping the values off of the data stack and translate them
-            // into the native types for the foreign function call.
-            builder.SetInsertPoint(entry_block);
+                    auto [ taken_weight, not_taken_weight ] = scale_weights(taken, not_taken);
 
-            // Allocate a variable for each parameter.
-            std::vector<llvm::AllocaInst*> parameter_variables;
-            parameter_variables.reserve(parameter_count);
+                    profiled.branches[i]->setMetadata(llvm::LLVMContext::MD_prof,
+                                                      md_builder.createBranchWeights(
+                                                                            taken_weight,
+                                                                            not_taken_weight));
+                }
+            }
 
-            for (size_t i = 0; i < parameter_count; ++i)
+            if (mismatched > 0)
             {
-                auto& ffi_parameter = word_ffi_info.parameters[i];
-                auto parameter_variable = builder.CreateAlloca(ffi_parameter.type.type,
-                                                               nullptr,
-                                                               "ffi_parameter");
+                std::cerr << "Warning: The profile data for " << mismatched << " function(s) "
+                          << "doesn't match the code, the program may have changed since the "
+                          << "profile was collected." << std::endl;
+            }
 
-                if (ffi_parameter.type.alignment != -1)
-                {
-                    parameter_variable->setAlignment(llvm::Align(ffi_parameter.type.alignment));
-                }
+            // The summary lets the optimizer decide what counts as hot or cold code.
+            module->setProfileSummary(summary_builder.getSummary()->getMD(context),
+                                      llvm::ProfileSummary::PSK_Instr);
+        }
 
-                parameter_variables.push_back(parameter_variable);
+
+        // Map our optimization levels to LLVM's code generator levels.
+        llvm::CodeGenOptLevel get_codegen_level(OptimizationLevel level)
+        {
+            switch (level)
+            {
+                case OptimizationLevel::O0: return llvm::CodeGenOptLevel::None;
+                case OptimizationLevel::O1: return llvm::CodeGenOptLevel::Less;
+                case OptimizationLevel::O3: return llvm::CodeGenOptLevel::Aggressive;
+                default:                    break;
             }
 
-            // Generate the code to translate an pop the values off of the stack.  We'll need to
-            // pop the parameters in reverse order.
-            for (ssize_t i = parameter_count - 1; i >= 0; --i)
+            return llvm::CodeGenOptLevel::Default;
+        }
+
+
+        // Create the target machine for the processor we're generating code for.  If asked for
+        // the native processor we use the host's processor and the features that it supports.
+        std::unique_ptr<llvm::TargetMachine> create_target_machine(const CodeGenOptions& options)
+        {
+            // Get the target triple for the host machine.
+            auto target_triple = llvm::sys::getDefaultTargetTriple();
+
+            // Find the llvm target for the host machine.
+            std::string error;
+            const auto target = llvm::TargetRegistry::lookupTarget(target_triple, error);
+
+            if (!target)
             {
-                auto& ffi_parameter = word_ffi_info.parameters[i];
-                auto& parameter_variable = parameter_variables[i];
+                throw_error("Failed to lookup LLVM target: " + error);
+            }
 
+            auto cpu = options.cpu;
+            std::string features;
 
-                // Call the type handler to generate the code to pop the value off of the stack and
-                // translate it into the native type.
-                auto param_direction = ffi_parameter.type.direction;
+            if (cpu == "native")
+            {
+                cpu = llvm::sys::getHostCPUName().str();
 
-                // If the parameter is an input or in/out parameter, we need to pop the value off
-                // of the stack, otherwise we don't actually generate any code to pop the value.
-                llvm::Value* pop_result = nullptr;
+                llvm::StringMap<bool> host_features;
 
-                if (param_direction != PassDirection::out)
+                if (llvm::sys::getHostCPUFeatures(host_features))
                 {
-                    pop_result = ffi_parameter.type.pop_value(builder,
-                                                              runtime_api,
-                                                              parameter_variable);
+                    for (const auto& feature : host_features)
+                    {
+                        features += features.empty() ? "" : ",";
+                        features += (feature.second ? "+" : "-") + feature.first().str();
+                    }
                 }
+            }
 
-                // Now we need to generate the code to check to see if the pop was successful.
-                if (pop_result != nullptr)
-                {
-                    auto comparison_result = builder.CreateICmpNE(pop_result, builder.getInt1(0));
-                    auto next_block = generate_block();
+            // Make sure that the processor is one that LLVM knows about.
+            auto subtarget_info = std::unique_ptr<llvm::MCSubtargetInfo>(
+                                        target->createMCSubtargetInfo(target_triple, "", ""));
 
-                    // If the pop was successful, we can move on to the next parameter.  Otherwise
-                    // we need to jump to the error block.
-                    builder.CreateCondBr(comparison_result,
-                                        exit_error_block,
-                                        next_block);
+            if (!subtarget_info->isCPUStringValid(cpu))
+            {
+                throw_error("Unknown target processor: " + cpu + ".");
+            }
 
-                    // We are done with the current block, so move on to the next one.
-                    builder.SetInsertPoint(next_block);
-                }
+            // The features given explicitly come last so that they override the host's.
+            if (!options.features.empty())
+            {
+                features += features.empty() ? "" : ",";
+                features += options.features;
             }
 
-            // Now that all of our parameter variables have been populated, we can call the foreign
-            // function.  We need to load their values from those variables and pass them to the
-            // actual function call.
-            std::vector<llvm::Value*> loaded_parameters;
+            llvm::TargetOptions target_options;
 
-            loaded_parameters.reserve(parameter_count);
+            // Give every function and global a section of it's own, so that the linker can order
+            // the words by how hot they are and drop the ones that aren't used.
+            target_options.FunctionSections = true;
+            target_options.DataSections = true;
 
-            // First generate the loads.
-            for (size_t i = 0; i < parameter_count; ++i)
+            auto reloc_model = std::optional<llvm::Reloc::Model>(llvm::Reloc::PIC_);
+            auto codegen_level = get_codegen_level(options.optimization_level);
+
+            auto target_machine = std::unique_ptr<llvm::TargetMachine>(
+                                                target->createTargetMachine(target_triple,
+                                                                            cpu,
+                                                                            features,
+                                                                            target_options,
+                                                                            reloc_model,
+                                                                            std::nullopt,
+                                                                            codegen_level));
+
+            return target_machine;
+        }
+
+
+        // The generated code declares the run-time's functions as returning i1, while the C++
+        // compiler gives the functions that return int8_t or uint8_t an i8 result.  Once the
+        // run-time's bitcode has been linked in, calls made through the mismatched type can't be
+        // inlined, so we rewrite them to use the function's real type.
+        void match_runtime_call_types(llvm::Module& module)
+        {
+            std::vector<llvm::CallInst*> mismatched_calls;
+
+            for (auto& function : module)
             {
-                auto& ffi_parameter = word_ffi_info.parameters[i];
-                llvm::Value* loaded_parameter = nullptr;
+                for (auto& block : function)
+                {
+                    for (auto& instruction : block)
+                    {
+                        auto call = llvm::dyn_cast<llvm::CallInst>(&instruction);
 
-                // Check to see if we're passing this parameter by value or by pointer.
-                if (ffi_parameter.type.passed_by == PassByType::value)
+                        if (!call)
+                        {
+                            continue;
+                        }
+
+                        auto callee = llvm::dyn_cast<llvm::Function>(call->getCalledOperand());
+
+                        if (   callee
+                            && callee->getFunctionType() != call->getFunctionType())
+                        {
+                            mismatched_calls.push_back(call);
+                        }
+                    }
+                }
+            }
+
+            for (auto call : mismatched_calls)
+            {
+                auto callee = llvm::cast<llvm::Function>(call->getCalledOperand());
+                auto callee_type = callee->getFunctionType();
+                auto call_type = call->getFunctionType();
+
+                // We only know how to fix up calls where the integer return types differ.
+                if (   callee_type->params() != call_type->params()
+                    || callee_type->isVarArg() != call_type->isVarArg()
+                    || !callee_type->getReturnType()->isIntegerTy()
+                    || !call_type->getReturnType()->isIntegerTy())
                 {
-                    // We're passing by value, so we need to load the value from the variable
-                    // directly.
-                    loaded_parameter = builder.CreateLoad(ffi_parameter.type.type,
-                                                          parameter_variables[i]);
+                    continue;
                 }
-                else if (ffi_parameter.type.passed_by == PassByType::pointer)
+
+                llvm::IRBuilder<> builder(call);
+                std::vector<llvm::Value*> arguments(call->arg_begin(), call->arg_end());
+
+                auto new_call = builder.CreateCall(callee_type, callee, arguments);
+                llvm::Value* result = nullptr;
+
+                if (call_type->getReturnType()->isIntegerTy(1))
                 {
-                    // We're passing by pointer, so take a pointer to the variable instead.
-                    loaded_parameter = builder.CreateStructGEP(ffi_parameter.type.type,
-                                                               parameter_variables[i],
-                                                               0);
+                    result = builder.CreateICmpNE(new_call,
+                                                  llvm::ConstantInt::get(new_call->getType(), 0));
                 }
                 else
                 {
-                    // We don't know how to pass this parameter type.
-                    throw_error("Internal error, unknown pass-by type for parameter " +
-                                std::to_string(i) + " for " + word.name + ".");
+                    result = builder.CreateIntCast(new_call, call_type->getReturnType(), false);
                 }
 
-                // Store the loaded parameter for in our parameter list.
-                loaded_parameters.push_back(loaded_parameter);
+                call->replaceAllUsesWith(result);
+                call->eraseFromParent();
             }
+        }
 
-            // We've loaded all the parameters now we need to allocate space for the return value.
-            auto return_value_variable = builder.CreateAlloca(word_ffi_info.return_type.type,
-                                                              nullptr,
-                                                              "ffi_return_variable");
-
-            if (word_ffi_info.return_type.alignment != -1)
-            {
-                return_value_variable->
-                                     setAlignment(llvm::Align(word_ffi_info.return_type.alignment));
-            }
 
-            // Finally we can call the function.
-            auto call_result = builder.CreateCall(word_ffi_info.function,
-                                                  loaded_parameters);
-            builder.CreateStore(call_result, return_value_variable);
+        // Link the run-time library's bitcode into the module so that the optimizer can inline
+        // the run-time's functions into the generated code.  The whole run-time is brought in,
+        // that way the object file defines everything the program needs from it and the linker
+        // won't pull any of the run-time library's own objects into the executable.
+        void link_runtime_bitcode(const std::shared_ptr<llvm::Module>& module,
+                                  const std::filesystem::path& bitcode_path)
+        {
+            llvm::SMDiagnostic diagnostic;
+            auto runtime_module = llvm::parseIRFile(bitcode_path.string(),
+                                                    diagnostic,
+                                                    module->getContext());
 
-            // Generate pushes for all out parameters.
-            for (size_t i = 0; i < parameter_count; ++i)
+            if (!runtime_module)
             {
-                auto& ffi_parameter = word_ffi_info.parameters[i];
-                auto direction = ffi_parameter.type.direction;
-
-                if (   (direction == PassDirection::out)
-                    || (direction == PassDirection::in_out))
-                {
-                    auto push_result = ffi_parameter.type.push_value(builder,
-                                                                     runtime_api,
-                                                                     parameter_variables[i]);
-
-                    if (push_result != nullptr)
-                    {
-                        auto comparison_result = builder.CreateICmpNE(push_result,
-                                                                      builder.getInt1(0));
+                throw_error("Failed to load the run-time bitcode " + bitcode_path.string() + ": " +
+                            diagnostic.getMessage().str());
+            }
 
-                        // If the push was successful, we can move on to the next parameter.
-                        // Otherwise we need to jump to the error block.
-                        auto next_block = generate_block();
+            // The run-time is generated for the same processor as the user code.  Dropping the
+            // processor the C++ compiler picked lets the run-time's code pick up the -mcpu and
+            // -mattr options, and keeps the inliner from refusing to mix the two.
+            runtime_module->setTargetTriple(module->getTargetTriple());
+            runtime_module->setDataLayout(module->getDataLayout());
 
-                        builder.CreateCondBr(comparison_result,
-                                             exit_error_block,
-                                             next_block);
+            for (auto& function : *runtime_module)
+            {
+                function.removeFnAttr("target-cpu");
+                function.removeFnAttr("target-features");
+                function.removeFnAttr("tune-cpu");
+            }
 
-                        // We are done with the current block, so move on to the next one.
-                        builder.SetInsertPoint(next_block);
-                    }
-                }
+            if (llvm::Linker::linkModules(*module, std::move(runtime_module)))
+            {
+                throw_error("Failed to link the run-time bitcode " + bitcode_path.string() + ".");
             }
 
-            // Generate the push for the return value.
-            word_ffi_info.return_type.push_value(builder,
-                                                  runtime_api,
-                                                  return_value_variable);
+            match_runtime_call_types(*module);
 
-            // Now that we're done here we can jump to the exit block.
-            builder.CreateBr(exit_block);
+            if (verifyModule(*module, &llvm::errs()))
+            {
+                throw_error("LLVM IR module is invalid after linking the run-time bitcode.");
+            }
         }
 
 
-        void generate_ir_for_ffi_accessor(WordCollection& collection,
-                                          const WordInfo& word,
-                                          std::shared_ptr<llvm::Module>& module,
-                                          llvm::LLVMContext& context,
-                                          llvm::IRBuilder<>& builder,
-                                          const RuntimeApi& runtime_api)
+        // Write the module to an object file, compiling it to native code on this thread.
+        void emit_object_file(const std::shared_ptr<llvm::Module>& module,
+                              llvm::TargetMachine& target_machine,
+                              const std::filesystem::path& output_path)
         {
-            auto bool_type = llvm::Type::getInt1Ty(context);
-            auto& word_ffi_info = std::get<FfiVariableInfo>(word.extra_info);
+            std::error_code error_code;
+            llvm::raw_fd_ostream output_stream(output_path.string(), error_code);
 
-            // Create the entry point for the wrapper function.
-            auto entry_block = llvm::BasicBlock::Create(context, "entry_block", word.function);
-            builder.SetInsertPoint(entry_block);
-            auto return_variable = builder.CreateAlloca(bool_type,
-                                                        nullptr,
-                                                        "return_variable");
-            builder.CreateStore(builder.getInt1(0), return_variable);
+            if (error_code)
+            {
+                throw_error("Failed to open output file: " + error_code.message());
+            }
 
-            // Create the exit and error blocks.
-            auto error_block = llvm::BasicBlock::Create(context, "error_block", word.function);
-            auto exit_block = llvm::BasicBlock::Create(context, "exit_block", word.function);
+            llvm::legacy::PassManager pass_manager;
 
-            // Generate the code to report errors.
-            builder.SetInsertPoint(error_block);
-            builder.CreateStore(builder.getInt1(1), return_variable);
-            builder.CreateBr(exit_block);
+            if (target_machine.addPassesToEmitFile(pass_manager,
+                                                   output_stream,
+                                                   nullptr,
+                                                   llvm::CodeGenFileType::ObjectFile))
+            {
+                throw_error("Failed to setup target machine to emit object file.");
+            }
 
-            // Generate the code to return the result.
-            builder.SetInsertPoint(exit_block);
-            auto return_value = builder.CreateLoad(bool_type, return_variable);
-            builder.CreateRet(return_value);
+            pass_manager.run(*module);
+            output_stream.flush();
+        }
 
-            // Generate the code to read or write the variable.
-            builder.SetInsertPoint(entry_block);
 
-            llvm::Value* handler_result = nullptr;
+        // Split the optimized module into partitions and compile them to native code on a pool of
+        // threads.  The partitions' objects are then combined into the one output object with a
+        // relocatable link, so that sorthl still only has to deal with a single object file.
+        //
+        // The split happens after optimization so that the inliner still sees the whole program.
+        void emit_object_file_parallel(const std::shared_ptr<llvm::Module>& module,
+                                       const CodeGenOptions& options,
+                                       const std::filesystem::path& output_path)
+        {
+            auto linker = llvm::sys::findProgramByName("ld");
 
-            if (word_ffi_info.handler_type == FfiVariableHandler::reader)
+            if (!linker)
             {
-                // We're reading, so we need to generate the code to read the value from the global
-                // and push it onto the stack.
-                handler_result = word_ffi_info.type.push_value(builder,
-                                                               runtime_api,
-                                                               word_ffi_info.global);
+                throw_error("Could not find the system linker to combine the object files: " +
+                            linker.getError().message());
             }
-            else
+
+            std::vector<std::string> partition_paths;
+            std::vector<std::unique_ptr<llvm::raw_fd_ostream>> partition_streams;
+            std::vector<llvm::raw_pwrite_stream*> output_streams;
+
+            auto remove_partitions = [&]()
+                {
+                    partition_streams.clear();
+
+                    for (const auto& path : partition_paths)
+                    {
+                        llvm::sys::fs::remove(path);
+                    }
+                };
+
+            for (unsigned i = 0; i < options.codegen_threads; ++i)
             {
-                // We're writing, so we need to generate the code to pop the value from the stack
-                // and write it to the global.
-                handler_result = word_ffi_info.type.pop_value(builder,
-                                                              runtime_api,
-                                                              word_ffi_info.global);
+                int file_descriptor = -1;
+                llvm::SmallString<128> path;
+
+                auto error_code = llvm::sys::fs::createTemporaryFile("sorthc-partition",
+                                                                     "o",
+                                                                     file_descriptor,
+                                                                     path);
+
+                if (error_code)
+                {
+                    remove_partitions();
+                    throw_error("Failed to create a temporary object file: " +
+                                error_code.message());
+                }
+
+                partition_paths.push_back(path.str().str());
+                partition_streams.push_back(std::make_unique<llvm::raw_fd_ostream>(file_descriptor,
+                                                                                   true));
+                output_streams.push_back(partition_streams.back().get());
             }
 
-            // See if we need to generate the code to check for errors.
-            if (handler_result != nullptr)
-            {
-                auto cmp = builder.CreateICmpNE(handler_result, builder.getInt1(0));
-                auto check_block = llvm::BasicBlock::Create(context,
-                                                            "check_block",
-                                                            word.function);
+            // Each of the code generation threads gets a target machine of it's own.  The options
+            // have already been checked when the main target machine was created.
+            llvm::splitCodeGen(*module,
+                               output_streams,
+                               {},
+                               [&options]() { return create_target_machine(options); },
+                               llvm::CodeGenFileType::ObjectFile);
 
-                builder.CreateCondBr(cmp, error_block, check_block);
-                builder.SetInsertPoint(check_block);
+            // Make sure that everything has been written out before handing the files to the
+            // linker.
+            partition_streams.clear();
+
+            std::string output = output_path.string();
+            std::vector<llvm::StringRef> arguments = { *linker, "-r", "-o", output };
+
+            for (const auto& path : partition_paths)
+            {
+                arguments.push_back(path);
             }
 
-            // We're done here, so jump to the exit block.
-            builder.CreateBr(exit_block);
+            std::string error_message;
+            auto result = llvm::sys::ExecuteAndWait(*linker,
+                                                    arguments,
+                                                    {},
+                                                    {},
+                                                    0,
+                                                    0,
+                                                    &error_message);
+
+            remove_partitions();
+
+            if (result != 0)
+            {
+                throw_error("Failed to combine the object files into " + output + ": " +
+                            (error_message.empty() ? "ld exited with " + std::to_string(result)
+                                                   : error_message) + ".");
+            }
         }
 
 
-        // Go through the collection of words and compile the ones that were referenced.
-        void compile_used_words(WordCollection& collection,
-                                std::shared_ptr<llvm::Module>& module,
-                                llvm::LLVMContext& context,
-                                llvm::IRBuilder<>& builder,
-                                const RuntimeApi& runtime_api,
-                                GlobalMap& global_constant_map)
+        // Write the order that the linker should lay out the optimized functions in.  Functions
+        // that a profile says are hot come first, most called first.  After them come the
+        // functions reachable from the top level, each caller followed by what it calls, so that
+        // code that runs together sits together.  Cold functions, like the error paths split out
+        // by the optimizer, go last.
+        void write_symbol_order_file(const std::shared_ptr<llvm::Module>& module,
+                                     const std::filesystem::path& order_path)
         {
-            for (const auto& word : collection.words)
+            std::vector<llvm::Function*> order;
+            std::unordered_set<llvm::Function*> ordered;
+            std::vector<llvm::Function*> hot_functions;
+            std::vector<llvm::Function*> cold_functions;
+
+            auto is_cold = [](llvm::Function* function)
+                {
+                    auto count = function->getEntryCount();
+
+                    return    function->hasFnAttribute(llvm::Attribute::Cold)
+                           || (count && count->getCount() == 0);
+                };
+
+            for (auto& function : *module)
             {
-                // If the word was referenced and is a Forth word...
-                if (word.was_referenced)
+                if (function.isDeclaration())
                 {
-                    // Is this a Forth word?  Or is it a wrapper for a foreign function?
-                    if (std::holds_alternative<byte_code::ByteCode>(word.extra_info))
-                    {
-                        // Create the word's IR function body.
-                        generate_ir_for_byte_code(collection,
-                                                  word.name,
-                                                  std::get<byte_code::ByteCode>(word.extra_info),
-                                                  module,
-                                                  context,
-                                                  builder,
-                                                  word.function,
-                                                  global_constant_map,
-                                                  runtime_api,
-                                                  false);
-                    }
-                    else if (std::holds_alternative<FfiFunctionInfo>(word.extra_info))
-                    {
-                        // Create the word's wrapper code for the underlying FFI function.
-                        generate_ir_for_ffi_function(collection,
-                                                     word,
-                                                     module,
-                                                     context,
-                                                     builder,
-                                                     runtime_api);
-                    }
-                    else if (std::holds_alternative<FfiVariableInfo>(word.extra_info))
-                    {
-                        // We have a variable accessor.  So generate the code for reading or writing
-                        // to/from the global variable.
+                    continue;
+                }
 
-                        generate_ir_for_ffi_accessor(collection,
-                                                     word,
-                                                     module,
-                                                     context,
-                                                     builder,
-                                                     runtime_api);
-                    }
+                auto count = function.getEntryCount();
 
-                    // Looks like it's a word from the run-time library.  So there's nothing to do
-                    // here.
+                if (is_cold(&function))
+                {
+                    cold_functions.push_back(&function);
+                }
+                else if (count)
+                {
+                    hot_functions.push_back(&function);
                 }
             }
-        }
 
+            std::stable_sort(hot_functions.begin(),
+                             hot_functions.end(),
+                             [](llvm::Function* a, llvm::Function* b)
+                             {
+                                 return a->getEntryCount()->getCount() >
+                                        b->getEntryCount()->getCount();
+                             });
 
-        void compile_top_level_code(WordCollection& collection,
-                                    const byte_code::ByteCode& top_level_code,
-                                    std::shared_ptr<llvm::Module>& module,
-                                    llvm::LLVMContext& context,
-                                    llvm::IRBuilder<>& builder,
-                                    const RuntimeApi& runtime_api,
-                                    GlobalMap& global_constant_map)
-        {
-            // Start off by creating the signature for the top-level function.
-            llvm::FunctionType* top_level_signature =
-                                            llvm::FunctionType::get(llvm::Type::getInt1Ty(context),
-                                                                    false);
+            for (auto function : hot_functions)
+            {
+                order.push_back(function);
+                ordered.insert(function);
+            }
 
-            // Create the function itself.
-            llvm::Function* top_level_function =
-                                             llvm::Function::Create(top_level_signature,
-                                                                    llvm::Function::ExternalLinkage,
-                                                                    "script_top_level",
-                                                                    module.get());
+            // Walk the call graph from the top level of the script.
+            std::vector<llvm::Function*> stack;
 
-            generate_ir_for_byte_code(collection,
-                                      "script_top_level",
-                                      top_level_code,
-                                      module,
-                                      context,
-                                      builder,
-                                      top_level_function,
-                                      global_constant_map,
-                                      runtime_api,
-                                      true);
-        }
+            if (auto top_level = module->getFunction("script_top_level"))
+            {
+                stack.push_back(top_level);
+            }
 
+            while (!stack.empty())
+            {
+                auto function = stack.back();
+                stack.pop_back();
 
-        // Create the word table for the runtime.
-        void create_word_table(const WordCollection& collection,
-                               std::shared_ptr<llvm::Module>& module,
-                               llvm::LLVMContext& context)
-        {
-            auto function_type = llvm::FunctionType::get(llvm::Type::getInt1Ty(context), false);
-            auto function_ptr_type = llvm::PointerType::getUnqual(function_type);
-            auto table_size = collection.words.size();
+                if (   function->isDeclaration()
+                    || is_cold(function)
+                    || !ordered.insert(function).second)
+                {
+                    continue;
+                }
 
-            auto word_table_type = llvm::ArrayType::get(function_ptr_type, table_size);
-            std::vector<llvm::Constant*> word_table_values;
+                order.push_back(function);
 
-            for (size_t i = 0; i < table_size; ++i)
-            {
-                auto& word = collection.words[i];
+                // Push the callees in reverse so that they're visited in the order they're called.
+                std::vector<llvm::Function*> callees;
 
-                if (word.was_referenced)
+                for (auto& block : *function)
                 {
-                    word_table_values.push_back(word.function);
+                    for (auto& instruction : block)
+                    {
+                        if (auto call = llvm::dyn_cast<llvm::CallInst>(&instruction))
+                        {
+                            if (auto callee = call->getCalledFunction())
+                            {
+                                callees.push_back(callee);
+                            }
+                        }
+                    }
                 }
-                else
+
+                stack.insert(stack.end(), callees.rbegin(), callees.rend());
+            }
+
+            for (auto function : cold_functions)
+            {
+                if (ordered.insert(function).second)
                 {
-                    word_table_values.push_back(llvm::Constant::getNullValue(function_ptr_type));
+                    order.push_back(function);
                 }
             }
 
-            auto word_table_constant = llvm::ConstantArray::get(word_table_type, word_table_values);
+            std::ofstream stream(order_path);
 
-            auto word_table = new llvm::GlobalVariable(*module,
-                                                       word_table_type,
-                                                       true,
-                                                       llvm::GlobalValue::ExternalLinkage,
-                                                       word_table_constant,
-                                                       "word_table");
+            if (!stream)
+            {
+                throw_error("Failed to open the symbol order file " + order_path.string() + ".");
+            }
+
+            for (auto function : order)
+            {
+                stream << function->getName().str() << "\n";
+            }
         }
 
 
-        void optimize_module(const std::shared_ptr<llvm::Module>& module)
+        void optimize_module(const std::shared_ptr<llvm::Module>& module,
+                             llvm::TargetMachine& target_machine,
+                             OptimizationLevel level)
         {
-            // Create the pass manager that will run the optimization passes on the module.
-            llvm::PassBuilder pass_builder;
+            // Create the pass manager that will run the optimization passes on the module.  Giving
+            // it the target machine lets passes like the vectorizers know what the processor can
+            // do.
+            llvm::PassBuilder pass_builder(&target_machine);
             llvm::LoopAnalysisManager loop_am;
             llvm::FunctionAnalysisManager function_am;
             llvm::CGSCCAnalysisManager cgsccam;
@@ -4429,8 +8760,26 @@ namespace sorth::compilation
             pass_builder.registerLoopAnalyses(loop_am);
             pass_builder.crossRegisterProxies(loop_am, function_am, cgsccam, module_am);
 
-            llvm::ModulePassManager mpm =
-                            pass_builder.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O3);
+            llvm::ModulePassManager mpm;
+
+            if (level == OptimizationLevel::O0)
+            {
+                mpm = pass_builder.buildO0DefaultPipeline(llvm::OptimizationLevel::O0);
+            }
+            else
+            {
+                auto llvm_level = level == OptimizationLevel::O1 ? llvm::OptimizationLevel::O1
+                                : level == OptimizationLevel::O2 ? llvm::OptimizationLevel::O2
+                                : level == OptimizationLevel::Os ? llvm::OptimizationLevel::Os
+                                                                 : llvm::OptimizationLevel::O3;
+
+                mpm = pass_builder.buildPerModuleDefaultPipeline(llvm_level);
+
+                // Move the error handling code that the branch weights and cold functions mark as
+                // rarely run out into functions of their own, so that it doesn't take up room in
+                // the instruction cache alongside the code that is run.
+                mpm.addPass(llvm::HotColdSplittingPass());
+            }
 
             // Now, run the optimization passes on the module.
             mpm.run(*module, module_am);
@@ -4444,7 +8793,8 @@ namespace sorth::compilation
     // object file.
     void generate_llvm_ir(const byte_code::ScriptPtr& standard_library,
                           const byte_code::ScriptPtr& script,
-                          const std::filesystem::path& output_path)
+                          const std::filesystem::path& output_path,
+                          const CodeGenOptions& options)
     {
         // Create the LLVM context for the compilation, then create the module that will hold the
         // generated LLVM IR.
@@ -4462,6 +8812,7 @@ namespace sorth::compilation
 
         gather_runtime_words(words);
         gather_script_words(standard_library, words);
+        gather_numeric_words(words);
         gather_script_words(script, words);
 
         // Create the structure words for the runtime and the standard library.  These words will
@@ -4494,6 +8845,9 @@ namespace sorth::compilation
         // Try to resolve all the calls in the top-level code.
         try_resolve_calls(words, top_level_code);
 
+        // Simplify the byte-code before we generate any IR for it.
+        optimize_byte_code(words, top_level_code, options.print_byte_code_stats);
+
         // Now that we have all the top-levels collected, we can go through that code and mark
         // words as used or unused.  Then make sure that all of the used words have been properly
         // declared.
@@ -4528,9 +8882,28 @@ namespace sorth::compilation
         compile_used_words(words, module, context, builder, runtime_api, const_map);
 
 
+        // Calls to words that can never fail don't need to be checked for errors.
+        remove_unneeded_error_checks(module);
+
         // Create the word_table for the runtime.
         create_word_table(words, module, context);
 
+        // Programs that can't start any threads get the cheaper, non-atomic, reference counting.
+        if (!uses_threads(words))
+        {
+            disable_atomic_reference_counts(module, context);
+        }
+
+        // Either add the counters to collect a profile, or attach one that was collected earlier.
+        if (!options.profile_generate.empty())
+        {
+            instrument_for_profiling(module, context, options.profile_generate);
+        }
+        else if (!options.profile_use.empty())
+        {
+            apply_profile(module, context, options.profile_use);
+        }
+
         // Uncomment this line to see the generated LLVM IR before validation and optimization.
         //module->print(llvm::outs(), nullptr);
 
@@ -4540,61 +8913,46 @@ namespace sorth::compilation
             throw_error("Generated LLVM IR module is invalid.");
         }
 
-        // Apply LLVM optimization passes to the module.
-        optimize_module(module);
-
-        // We've generated our code and optimized it, we can now write the LLVM IR to an object
-        // file.
-
-        // Get the target triple for the host machine.
-        auto target_triple = llvm::sys::getDefaultTargetTriple();
+        // Create the target machine for the processor we're generating code for.  The optimizer
+        // needs to know about the target as well.
+        auto target_machine = create_target_machine(options);
 
-        // Find the llvm target for the host machine.
-        std::string error;
-        const auto target = llvm::TargetRegistry::lookupTarget(target_triple, error);
+        // Set the module's target triple and data layout.
+        module->setTargetTriple(target_machine->getTargetTriple().str());
+        module->setDataLayout(target_machine->createDataLayout());
 
-        if (!target)
+        // If we were given the run-time's bitcode, link it in so that the run-time is optimized
+        // along with the user code.
+        if (!options.runtime_bitcode.empty())
         {
-            throw_error("Failed to lookup LLVM target: " + error);
+            link_runtime_bitcode(module, options.runtime_bitcode);
         }
 
-        // Set the module's target triple and data layout.
-        llvm::TargetOptions options;
+        // Apply LLVM optimization passes to the module.
+        optimize_module(module, *target_machine, options.optimization_level);
 
-        auto reloc_model = std::optional<llvm::Reloc::Model>(llvm::Reloc::PIC_);
-        auto target_machine = target->createTargetMachine(target_triple,
-                                                          "generic",
-                                                          "",
-                                                          options,
-                                                          reloc_model);
+        // Let sorthl know what order to lay the functions out in, it picks up the order file that
+        // sits next to the object file.
+        auto order_path = output_path;
 
-        module->setTargetTriple(target_triple);
-        module->setDataLayout(target_machine->createDataLayout());
+        write_symbol_order_file(module, order_path.replace_extension(".order"));
+
+        // We've generated our code and optimized it, we can now write the LLVM IR to an object
+        // file.
 
         // Uncomment the following line to print the module to stdout for debugging.
         //module->print(llvm::outs(), nullptr);
 
-        // Write the module to an object file while compiling it to native code.
-        std::error_code error_code;
-        llvm::raw_fd_ostream output_stream(output_path.string(), error_code);
-
-        if (error_code)
+        // Write the module to an object file while compiling it to native code, using more than one
+        // thread if we've been asked to.
+        if (options.codegen_threads > 1)
         {
-            throw_error("Failed to open output file: " + error_code.message());
+            emit_object_file_parallel(module, options, output_path);
         }
-
-        llvm::legacy::PassManager pass_manager;
-
-        if (target_machine->addPassesToEmitFile(pass_manager,
-                                                output_stream,
-                                                nullptr,
-                                                llvm::CodeGenFileType::ObjectFile))
+        else
         {
-            throw_error("Failed to setup target machine to emit object file.");
+            emit_object_file(module, *target_machine, output_path);
         }
-
-        pass_manager.run(*module);
-        output_stream.flush();
     }
 
 
@@ -7,11 +7,57 @@ namespace sorth::compilation
 {
 
 
+    // How hard should LLVM work at optimizing the generated code.
+    enum class OptimizationLevel
+    {
+        O0,
+        O1,
+        O2,
+        O3,
+        Os
+    };
+
+
+    // The options that control how the native code is generated.
+    struct CodeGenOptions
+    {
+        // The level of optimization to run over the generated LLVM IR.
+        OptimizationLevel optimization_level = OptimizationLevel::O3;
+
+        // The processor to generate code for, "native" for the processor of the machine we're
+        // running on.
+        std::string cpu = "generic";
+
+        // Extra processor features to enable or disable, in LLVM's "+avx2,-bmi" format.
+        std::string features;
+
+        // If set, the run-time library's bitcode to link into the generated code so that the
+        // run-time's words can be inlined and optimized along with the program.
+        std::filesystem::path runtime_bitcode;
+
+        // How many threads to generate native code on.  With more than one the module is split
+        // into that many partitions that are compiled at the same time.
+        unsigned codegen_threads = 1;
+
+        // If set, add counters to the generated code and have the program write them to this
+        // file as it exits.
+        std::filesystem::path profile_generate;
+
+        // If set, a profile collected by an instrumented build of the same program, used to guide
+        // the optimizer.
+        std::filesystem::path profile_use;
+
+        // Print what each of the byte-code optimization passes did to stderr.
+        bool print_byte_code_stats = false;
+    };
+
+
     // Generate the LLVM IR for a script and it's sub-scripts, and write the resulting IR to an
     // object file.
     void generate_llvm_ir(const byte_code::ScriptPtr& standard_library,
                           const byte_code::ScriptPtr& script,
-                          const std::filesystem::path& output_path);
+                          const std::filesystem::path& output_path,
+                          const CodeGenOptions& options = {});
 
 
 }
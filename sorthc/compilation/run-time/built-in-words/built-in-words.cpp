@@ -394,6 +394,15 @@ namespace sorth::compilation::run_time::built_in_words
         }
 
 
+        void word_nip(CompilerRuntime& runtime)
+        {
+            auto b = runtime.pop();
+
+            runtime.pop();
+            runtime.push(b);
+        }
+
+
         void word_start_word(CompilerRuntime& runtime)
         {
             // Get the name and location of the word we are defining from the next token.
@@ -1152,6 +1161,7 @@ namespace sorth::compilation::run_time::built_in_words
         ADD_NATIVE_WORD(runtime, "swap", word_swap);
         ADD_NATIVE_WORD(runtime, "over", word_over);
         ADD_NATIVE_WORD(runtime, "rot", word_rot);
+        ADD_NATIVE_WORD(runtime, "nip", word_nip);
 
         // Word creation words.
         ADD_NATIVE_IMMEDIATE_WORD(runtime, ":", word_start_word);
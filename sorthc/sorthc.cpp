@@ -120,6 +120,121 @@ namespace
 
         return get_executable_directory();
     }
+
+
+    const char* usage = "Usage: sorthc [-O0|-O1|-O2|-O3|-Os] [-mcpu=<cpu>|native] "
+                        "[-mattr=<features>] [-flto] [-j<threads>] "
+                        "[--profile-generate=<file>|--profile-use=<file>] "
+                        "[--byte-code-stats] <source-file> <output-file>";
+
+
+    // Find the run-time library's bitcode, it's built alongside the run-time library itself when
+    // the SORTH_RUNTIME_BITCODE build option is enabled.
+    std::filesystem::path get_runtime_bitcode_path()
+    {
+        auto path = get_executable_directory() / "sorth-runtime.bc";
+
+        if (!std::filesystem::exists(path))
+        {
+            throw std::runtime_error("The run-time bitcode " + path.string() + " was not found, "
+                                     "build with SORTH_RUNTIME_BITCODE enabled to use -flto.");
+        }
+
+        return path;
+    }
+
+
+    // Read the compiler options and the source and output files from the command line.
+    std::tuple<sorth::compilation::CodeGenOptions, std::vector<std::string>>
+                                                        parse_command_line(int argc, char* argv[])
+    {
+        using sorth::compilation::OptimizationLevel;
+
+        static const std::unordered_map<std::string, OptimizationLevel> levels =
+            {
+                { "-O0", OptimizationLevel::O0 },
+                { "-O1", OptimizationLevel::O1 },
+                { "-O2", OptimizationLevel::O2 },
+                { "-O3", OptimizationLevel::O3 },
+                { "-Os", OptimizationLevel::Os }
+            };
+
+        sorth::compilation::CodeGenOptions options;
+        std::vector<std::string> files;
+
+        for (int i = 1; i < argc; ++i)
+        {
+            std::string argument = argv[i];
+            auto level = levels.find(argument);
+
+            if (level != levels.end())
+            {
+                options.optimization_level = level->second;
+            }
+            else if (argument.starts_with("-mcpu="))
+            {
+                options.cpu = argument.substr(6);
+            }
+            else if (argument.starts_with("-mattr="))
+            {
+                options.features = argument.substr(7);
+            }
+            else if (argument == "-flto")
+            {
+                options.runtime_bitcode = get_runtime_bitcode_path();
+            }
+            else if (argument.starts_with("--profile-generate="))
+            {
+                options.profile_generate = argument.substr(19);
+            }
+            else if (argument.starts_with("--profile-use="))
+            {
+                options.profile_use = argument.substr(14);
+            }
+            else if (argument == "--byte-code-stats")
+            {
+                options.print_byte_code_stats = true;
+            }
+            else if (argument == "-j")
+            {
+                options.codegen_threads = std::max(std::thread::hardware_concurrency(), 1u);
+            }
+            else if (argument.starts_with("-j"))
+            {
+                char* end = nullptr;
+                auto threads = std::strtol(argument.c_str() + 2, &end, 10);
+
+                if (   *end != '\0'
+                    || threads < 1)
+                {
+                    throw std::runtime_error("Unknown option " + argument + ".\n" + usage);
+                }
+
+                options.codegen_threads = static_cast<unsigned>(threads);
+            }
+            else if (argument.starts_with("-"))
+            {
+                throw std::runtime_error("Unknown option " + argument + ".\n" + usage);
+            }
+            else
+            {
+                files.push_back(argument);
+            }
+        }
+
+        if (files.size() != 2)
+        {
+            throw std::runtime_error(usage);
+        }
+
+        if (   !options.profile_generate.empty()
+            && !options.profile_use.empty())
+        {
+            throw std::runtime_error("Can not both generate and use a profile at the same time.");
+        }
+
+        return { options, files };
+    }
 }
 
 
@@ -130,16 +245,13 @@ int main(int argc, char* argv[])
 
     try
     {
+        auto [ options, files ] = parse_command_line(argc, argv);
+
         // Create a compiler and compile the source file.
         auto compiler = sorth::compilation::Compiler(get_std_lib_directory());
 
-        if (argc != 3)
-        {
-            throw std::runtime_error("Usage: sorthc <source-file> <output-file>");
-        }
-
         // Compile the source file, to the given output file.
-        compiler.compile(argv[1], argv[2]);
+        compiler.compile(files[0], files[1], options);
     }
     catch (const std::runtime_error& error)
     {
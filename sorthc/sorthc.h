@@ -38,6 +38,7 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <stack>
 #include <tuple>
 #include <filesystem>
@@ -45,11 +46,14 @@
 #include <functional>
 #include <optional>
 #include <exception>
+#include <thread>
 
 
 #include "sorth-runtime.h"
 
 
+#include <llvm/Analysis/ConstantFolding.h>
+#include <llvm/CodeGen/ParallelCG.h>
 #include <llvm/ExecutionEngine/ExecutionEngine.h>
 #include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
 #include <llvm/ExecutionEngine/Orc/LLJIT.h>
@@ -59,9 +63,12 @@
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/LLVMContext.h>
+#include <llvm/IR/MDBuilder.h>
 #include <llvm/IR/Module.h>
 #include <llvm/IR/Type.h>
 #include <llvm/IR/Verifier.h>
+#include <llvm/IRReader/IRReader.h>
+#include <llvm/Linker/Linker.h>
 #include <llvm/MC/MCAsmInfo.h>
 #include <llvm/MC/MCContext.h>
 #include <llvm/MC/MCDisassembler/MCDisassembler.h>
@@ -73,12 +80,20 @@
 #include <llvm/MC/MCSubtargetInfo.h>
 #include <llvm/Object/SymbolicFile.h>
 #include <llvm/Passes/PassBuilder.h>
+#include <llvm/ProfileData/InstrProf.h>
+#include <llvm/ProfileData/ProfileCommon.h>
 #include <llvm/TargetParser/Host.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/SourceMgr.h>
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Target/TargetOptions.h>
+#include <llvm/Transforms/IPO/HotColdSplitting.h>
 #include <llvm/Transforms/Scalar/GVN.h>
 #include <llvm/Transforms/Utils.h>
+#include <llvm/Transforms/Utils/Local.h>
+#include <llvm/Transforms/Utils/ModuleUtils.h>
 
 
 #include "error.h"
@@ -93,6 +108,7 @@
 #include "compilation/run-time/array.h"
 #include "compilation/byte-code/instruction.h"
 #include "compilation/byte-code/construction.h"
+#include "compilation/byte-code/optimizer.h"
 #include "compilation/byte-code/context.h"
 #include "compilation/run-time/dictionary.h"
 #include "compilation/run-time/contextual-list.h"
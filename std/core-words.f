@@ -406,64 +406,7 @@
 
 
 
-: drop description: "Drop the top item from the stack."
-       signature: "a -- "
-    variable! ignored
-;
-
-
-
-: swap description: "Swap the top two items on the stack."
-       signature: "a b -- b a"
-    variable! b
-    variable! a
-
-    b @
-    a @
-;
-
-
-
-: over description: "Duplicate the second item on the stack."
-       signature: "a b -- a b a"
-    variable! a
-    variable! b
-
-    a @
-    b @
-    a @
-;
-
-
-
-: rot description: "Rotate the top three items on the stack."
-      signature: "a b c -- b c a"
-    variable! c
-    variable! b
-    variable! a
-
-    c @
-    a @
-    b @
-;
-
-
-
-: dup description: "Duplicate the top item on the stack."
-      signature: "a -- a a"
-    variable! value
-
-    value @
-    value @
-;
-
-
-
-: nip description: "Nip the second from the top item from the stack."
-      signature: "a b c -- a c"
-    swap
-    drop
-;
+( dup, drop, swap, over, rot, and nip are implemented natively in the run-time library. )
 
 
 